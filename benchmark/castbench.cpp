@@ -1,22 +1,44 @@
 ///
 /// \file   benchmark/castbench.cpp
 /// \author wiluite
-/// \brief  Measures casts to "cast_to_type" type for a certain column.
+/// \brief  Measures casts to a certain type for a certain column.
 
 #include <csv_co/reader.hpp>
 #include <iostream>
 
-using cast_to_type = double;
+using namespace csv_co;
+
+template <typename cast_to_type>
+void measure(reader<> & r, std::size_t col) {
+    for (;;) {
+        auto const begin_wo = std::chrono::high_resolution_clock::now();
+        r.run_rows([](auto){}, [&](auto row) {cell_string s = row[col].operator cell_string();});
+        auto const end_wo = std::chrono::high_resolution_clock::now();
+        std::cout << "Execution Time Without Casts:  " << std::chrono::duration_cast<std::chrono::milliseconds>(end_wo-begin_wo).count() << " ms" << '\n';
+
+        auto const begin_w = std::chrono::high_resolution_clock::now();
+        r.run_rows([](auto){}, [&](auto row) {  row[col].template as<cast_to_type>();});
+        auto const end_w = std::chrono::high_resolution_clock::now();
+        std::cout << "Execution Time With Casts:     " << std::chrono::duration_cast<std::chrono::milliseconds>(end_w-begin_w).count() << " ms" << '\n';
+
+        if (std::chrono::duration_cast<std::chrono::microseconds>((end_w-begin_w)-(end_wo-begin_wo)).count() < 0) {
+            std::cout << "Intervention of external effects. Repeat." << '\n';
+            continue;
+        }
+        std::cout << "Execution Time Of All Casts:   " << std::chrono::duration_cast<std::chrono::microseconds>((end_w-begin_w) - (end_wo-begin_wo)).count() << " mks" << std::endl;
+
+        std::cout << "Mean Execution Time Of 1 Cast: " << std::chrono::duration_cast<std::chrono::nanoseconds>((end_w-begin_w) - (end_wo-begin_wo)).count() / (r.rows() - 1) << " ns" << std::endl;
+        break;
+    }
+}
 
 int main(int argc, char ** argv) {
 
-    if (argc != 3) {
-        std::cout << "Usage: ./castbench <csv_file> <zero_based_column_number>\n";
+    if (argc != 3 && argc != 4) {
+        std::cout << "Usage: ./castbench <csv_file> <zero_based_column_number> [double|float|int|long|unsigned]\n";
         return EXIT_FAILURE;
     }
 
-    using namespace csv_co;
-
     char * p_end;
     std::size_t col =  strtol(argv[2], &p_end, 10);
     if (argv[2] == p_end) {
@@ -24,6 +46,8 @@ int main(int argc, char ** argv) {
         exit(-13);
     }
 
+    std::string_view const cast_to_type = argc == 4 ? argv[3] : "double";
+
     try {
         reader r (std::filesystem::path {argv[1]});
         if (r.validate().cols() <= col) {
@@ -31,25 +55,19 @@ int main(int argc, char ** argv) {
             exit(-14);
         }
 
-        for (;;) {
-            auto const begin_wo = std::chrono::high_resolution_clock::now();
-            r.run_rows([](auto){}, [&](auto row) {cell_string s = row[col].operator cell_string();});
-            auto const end_wo = std::chrono::high_resolution_clock::now();
-            std::cout << "Execution Time Without Casts:  " << std::chrono::duration_cast<std::chrono::milliseconds>(end_wo-begin_wo).count() << " ms" << '\n';
-
-            auto const begin_w = std::chrono::high_resolution_clock::now();
-            r.run_rows([](auto){}, [&](auto row) {  row[col].template as<cast_to_type>();});
-            auto const end_w = std::chrono::high_resolution_clock::now();
-            std::cout << "Execution Time With Casts:     " << std::chrono::duration_cast<std::chrono::milliseconds>(end_w-begin_w).count() << " ms" << '\n';
-
-            if (std::chrono::duration_cast<std::chrono::microseconds>((end_w-begin_w)-(end_wo-begin_wo)).count() < 0) {
-                std::cout << "Intervention of external effects. Repeat." << '\n';
-                continue;
-            }
-            std::cout << "Execution Time Of All Casts:   " << std::chrono::duration_cast<std::chrono::microseconds>((end_w-begin_w) - (end_wo-begin_wo)).count() << " mks" << std::endl;
-
-            std::cout << "Mean Execution Time Of 1 Cast: " << std::chrono::duration_cast<std::chrono::nanoseconds>((end_w-begin_w) - (end_wo-begin_wo)).count() / (r.rows() - 1) << " ns" << std::endl;
-            break;
+        if (cast_to_type == "double")
+            measure<double>(r, col);
+        else if (cast_to_type == "float")
+            measure<float>(r, col);
+        else if (cast_to_type == "int")
+            measure<int>(r, col);
+        else if (cast_to_type == "long")
+            measure<long long>(r, col);
+        else if (cast_to_type == "unsigned")
+            measure<unsigned>(r, col);
+        else {
+            std::cout << "Unknown cast type: " << cast_to_type << std::endl;
+            exit(-15);
         }
 
     } catch (reader<>::exception const & e) {
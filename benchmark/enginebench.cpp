@@ -0,0 +1,71 @@
+///
+/// \file   benchmark/enginebench.cpp
+/// \author wiluite
+/// \brief  Cost of the coroutine machinery: the coroutine-driven and the direct two-stage engines on small and large inputs.
+
+#include <csv_co/reader.hpp>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+    using namespace csv_co;
+
+    template <typename Engine>
+    using engine_reader = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::no_trace, ER::std_4180, Engine>;
+
+    /// Microseconds spent on `times` span iterations and validations, a new reader over the source each time
+    template <typename Engine, typename Source>
+    std::size_t measure(Source const & source, std::size_t times, std::size_t & cells) {
+        auto const begin = std::chrono::high_resolution_clock::now();
+        cells = 0;
+        for (auto i = times; i; --i) {
+            engine_reader<Engine> r (source);
+            r.run_spans([&cells](auto &) { ++cells; });
+            cells += r.validate().validated_rows();
+        }
+        auto const end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    }
+
+    template <typename Source>
+    void compare(char const * title, Source const & source, std::size_t times) {
+        std::size_t coro_cells, direct_cells;
+        auto const coro = measure<engine::structural_index>(source, times, coro_cells);
+        auto const direct = measure<engine::direct>(source, times, direct_cells);
+        if (coro_cells != direct_cells)
+            throw std::runtime_error("the engines disagree");
+
+        std::cout << title << " (" << times << " runs)\n" << std::fixed << std::setprecision(3)
+                  << "  coroutines     : " << static_cast<double>(coro) / times << " us/run\n"
+                  << "  direct         : " << static_cast<double>(direct) / times << " us/run\n";
+        if (direct)
+            std::cout << "  ratio          : " << static_cast<double>(coro) / direct << '\n';
+    }
+}
+
+int main(int argc, char ** argv) {
+
+    if (argc != 2) {
+        std::cout << "Usage: ./enginebench <csv_file>\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        // a handful of rows: frame allocations and resumptions are a visible share of the work
+        std::string small;
+        {
+            std::ifstream ifs (argv[1]);
+            std::string line;
+            for (auto n = 10; n && std::getline(ifs, line); --n)
+                small += line + '\n';
+        }
+        compare("Small input: 10 rows", small, 100000);
+        compare("Large input: whole file", std::filesystem::path{argv[1]}, 5);
+    }
+    catch (std::exception const & e) {
+        std::cout << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,97 @@
+///
+/// \file   benchmark/longdoublebench.cpp
+/// \author wiluite
+/// \brief  Compares long double parsing by strtold() and by CSV_co's own parser on the numbers of a column, then on
+///         numbers of the kinds that go to the strtold() fallback: long digit runs, large exponents, hexadecimal ones.
+
+#include <csv_co/reader.hpp>
+#include <iostream>
+#include <random>
+
+int main(int argc, char ** argv) {
+
+    if (argc != 3) {
+        std::cout << "Usage: ./longdoublebench <csv_file> <zero_based_column_number>\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace csv_co;
+
+    char * p_end;
+    std::size_t col =  strtol(argv[2], &p_end, 10);
+    if (argv[2] == p_end) {
+        std::cout << "zero_based_column_number isn't numeric" << std::endl;
+        exit(-13);
+    }
+
+#ifndef _MSC_VER
+    try {
+        reader r (std::filesystem::path {argv[1]});
+        if (r.validate().cols() <= col) {
+            std::cout << "zero_based_column_number isn't found in " << argv[1] << std::endl;
+            exit(-14);
+        }
+
+        // terminated copies of the fields, as strtold() wants them
+        std::vector<std::string> fields;
+        r.run_rows([](auto){}, [&](auto row) { fields.emplace_back(row[col].operator unquoted_cell_string()); });
+
+        auto measure = [](std::vector<std::string> const & fields, auto && parse) {
+            long double sum = 0;
+            auto const begin = std::chrono::high_resolution_clock::now();
+            for (auto const & f : fields)
+                sum += parse(f);
+            auto const end = std::chrono::high_resolution_clock::now();
+            std::cout << "  Mean Execution Time Of 1 Parse: " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / fields.size() << " ns (sum " << sum << ")\n";
+        };
+
+        auto compare = [&](std::vector<std::string> const & fields) {
+            std::cout << "strtold():" << '\n';
+            measure(fields, [](std::string const & f) { return std::strtold(f.c_str(), nullptr); });
+            std::cout << "numbers::parse_long_double():" << '\n';
+            measure(fields, [](std::string const & f) {
+                long double v = 0;
+                numbers::parse_long_double(f.data(), f.data() + f.size(), v);
+                return v;
+            });
+
+            std::size_t differ = 0;
+            for (auto const & f : fields) {
+                long double v = 0;
+                numbers::parse_long_double(f.data(), f.data() + f.size(), v);
+                auto const expected = std::strtold(f.c_str(), nullptr);
+                differ += v != expected && !(std::isnan(v) && std::isnan(expected));
+            }
+            std::cout << "Values that differ: " << differ << " of " << fields.size() << std::endl;
+        };
+
+        compare(fields);
+
+        // Numbers that can't be converted with a single exact rounding, as many as the column has and no fewer than 100000
+        std::mt19937_64 gen (5);
+        auto const digits = [&](std::size_t n) {
+            std::string d (n, '0');
+            for (auto & c : d)
+                c = static_cast<char>('0' + gen() % 10);
+            return d;
+        };
+        std::vector<std::string> long_digits, large_exponents, hexadecimal;
+        for (auto i = 0u; i != std::max<std::size_t>(fields.size(), 100000); ++i) {
+            long_digits.push_back(digits(1 + gen() % 20) + '.' + digits(20 + gen() % 40));
+            large_exponents.push_back(digits(1 + gen() % 17) + 'e' + std::to_string(static_cast<int>(gen() % 9000) - 4500));
+            hexadecimal.push_back("0x1." + std::to_string(gen() % 1000000) + "p" + std::to_string(static_cast<int>(gen() % 200) - 100));
+        }
+        std::cout << "\nLong digit runs:\n";
+        compare(long_digits);
+        std::cout << "\nLarge exponents:\n";
+        compare(large_exponents);
+        std::cout << "\nHexadecimal numbers:\n";
+        compare(hexadecimal);
+
+    } catch (reader<>::exception const & e) {
+        std::cout << e.what() << std::endl;
+    }
+#else
+    std::cout << "long double is double here, parsed by std::from_chars()" << std::endl;
+#endif
+}
@@ -5,23 +5,27 @@
 
 #include <csv_co/reader.hpp>
 #include <iostream>
+#include <atomic>
 
 int main(int argc, char ** argv) {
 
-    if (argc != 2) {
-        std::cout << "Usage: ./rowsbench <csv_file>\n";
+    if (argc != 2 && argc != 3) {
+        std::cout << "Usage: ./rowsbench <csv_file> [threads]\n";
         return EXIT_FAILURE;
     }
 
     using namespace csv_co;
 
-    std::size_t num_exp = 5, accum_times = 0;
+    std::size_t num_exp = 5, accum_times = 0, csv_size = 0;
 
     try {
+        // parallel row iteration if the number of threads is given
+        auto const threads = (argc == 3) ? static_cast<unsigned>(std::stoul(argv[2])) : 0u;
+
         auto h_rows  {0u};
-        auto v_rows  {0u};
+        std::atomic<std::size_t> v_rows  {0u};
         auto h_cells {0u};
-        auto v_cells {0u};
+        std::atomic<std::size_t> v_cells {0u};
 
         auto const save_num_exp = num_exp;
 
@@ -30,16 +34,24 @@ int main(int argc, char ** argv) {
             h_rows = v_rows = h_cells = v_cells = 0;
 
             reader r (std::filesystem::path{argv[1]});
-            r.run_rows([&](auto &rs) {
+            csv_size = r.size();
+            auto const h = [&](auto &rs) {
                 ++h_rows;
                 for (auto & e : rs) {(void)e; ++h_cells;}
-            },[&](auto &rs) {
-                ++v_rows;
-                for (auto & e : rs) {(void)e; ++v_cells;}
-            });
+            };
+            if (threads)
+                r.run_rows_parallel(threads, h, [&](auto &rs) {
+                    v_rows.fetch_add(1, std::memory_order_relaxed);
+                    v_cells.fetch_add(rs.size(), std::memory_order_relaxed);
+                });
+            else
+                r.run_rows(h, [&](auto &rs) {
+                    ++v_rows;
+                    for (auto & e : rs) {(void)e; ++v_cells;}
+                });
 
             auto const end = std::chrono::high_resolution_clock::now();
-            accum_times += std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count();
+            accum_times += std::chrono::duration_cast<std::chrono::microseconds>(end-begin).count();
         }
 
         std::cout << "Header Rows    : " << h_rows  << '\n' <<
@@ -47,7 +59,9 @@ int main(int argc, char ** argv) {
                      "Header Cells   : " << h_cells << '\n' <<
                      "Value Cells    : " << v_cells << '\n';
 
-        std::cout << "Execution Time : " << accum_times/save_num_exp << " ms" << '\n';
+        std::cout << "Execution Time : " << accum_times/save_num_exp/1000 << " ms" << '\n';
+        if (accum_times)
+            std::cout << "Throughput     : " << static_cast<double>(csv_size) * save_num_exp / accum_times / 1000 << " GB/s" << '\n';
     }
     catch (reader<>::exception const & e) {
         std::cout << e.what() << std::endl;
@@ -17,6 +17,7 @@ int main(int argc, char ** argv) {
 
     std::size_t num_exp = 5;
     std::size_t accum_times = 0;
+    std::size_t csv_size = 0;
 
     try
     {
@@ -32,19 +33,22 @@ int main(int argc, char ** argv) {
             h_cells = v_cells = rows = 0;
 
             reader r (std::filesystem::path {argv[1]});
+            csv_size = r.size();
             r.run_spans([&h_cells](auto ) { ++h_cells; },
                         [&v_cells](auto ) { ++v_cells; },
                         [&rows] { ++rows; });
 
             auto const end = std::chrono::high_resolution_clock::now();
-            accum_times += std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count();
+            accum_times += std::chrono::duration_cast<std::chrono::microseconds>(end-begin).count();
         }
 
         std::cout << "Total Rows     : " << rows << '\n' <<
                      "Header Cells   : " << h_cells << '\n' <<
                      "Value Cells    : " << v_cells << '\n';
 
-        std::cout << "Execution Time : " << accum_times/save_num_exp << " ms" << '\n';
+        std::cout << "Execution Time : " << accum_times/save_num_exp/1000 << " ms" << '\n';
+        if (accum_times)
+            std::cout << "Throughput     : " << static_cast<double>(csv_size) * save_num_exp / accum_times / 1000 << " GB/s" << '\n';
 
     } catch (reader<>::exception const & e) {
         std::cout << e.what() << std::endl;
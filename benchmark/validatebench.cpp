@@ -8,8 +8,8 @@
 
 int main(int argc, char ** argv) {
 
-    if (argc != 2) {
-        std::cout << "Usage: ./validatebench <csv_file>\n";
+    if (argc != 2 && argc != 3) {
+        std::cout << "Usage: ./validatebench <csv_file> [threads]\n";
         return EXIT_FAILURE;
     }
 
@@ -18,7 +18,8 @@ int main(int argc, char ** argv) {
     try {
         auto const begin = std::chrono::high_resolution_clock::now();
         reader r (std::filesystem::path{argv[1]});
-        auto & _ {r.validate()};
+        // parallel validation if the number of threads is given
+        auto & _ {(argc == 3) ? r.validate<parallel>(static_cast<unsigned>(std::stoul(argv[2]))) : r.validate()};
         (void)_;
         auto const end = std::chrono::high_resolution_clock::now();
         std::cout << "Execution Time : " << std::chrono::duration_cast<std::chrono::milliseconds>(end-begin).count() << " ms \n";
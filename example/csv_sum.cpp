@@ -5,25 +5,32 @@
 
 #include <csv_co/reader.hpp>
 #include <iostream>
+#include <numeric>
 
 int main() {
     using namespace csv_co;
 
     try {
 
-        constexpr unsigned population_col = 3;
-        auto sum = 0u;
-
-        reader (std::filesystem::path("smallpop.csv"))
-                .run_spans([](auto){}, // skip header line
-                           [&](auto s) {
-                               static auto col{0u};
-                               if (col++ == population_col) {
-                                   try {sum += s.template as<unsigned>();}
-                                   catch(reader<>::exception const & e) { std::cout << e.what() << '\n'; }
-                                   col = 0;
-                               }
-                           });
+        reader r (std::filesystem::path("smallpop.csv"));
+
+        // the whole column at once, into a contiguous vector
+        auto const population = r.validate().column_as<unsigned>("population");
+        auto const sum = std::accumulate(population.begin(), population.end(), 0u);
+
+        // Alternatively, field by field:
+
+//        constexpr unsigned population_col = 3;
+//        auto sum = 0u;
+//        r.run_spans([](auto){}, // skip header line
+//                    [&](auto s) {
+//                        static auto col{0u};
+//                        if (col++ == population_col) {
+//                            try {sum += s.template as<unsigned>();}
+//                            catch(reader<>::exception const & e) { std::cout << e.what() << '\n'; }
+//                            col = 0;
+//                        }
+//                    });
 
         std::cout << "Total population is: " << sum << std::endl;
     } catch (reader<>::exception const & e) {
@@ -1,6 +1,17 @@
 #include "../bzip2/bzlib.h"
+#include "bz2_connector.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #if defined(__unix__)
 #define BZ_UNIX 1
@@ -131,112 +142,583 @@ namespace bz2_connector::detail {
         return exists;
     }
 
-    constexpr std::size_t obuf_size = 1000000;
-    static_assert(obuf_size == BZ_MAX_UNUSED);
+    constexpr std::size_t obuf_size = 1 << 18;
 
-    UChar   obuf[obuf_size];
-    UChar   unused[BZ_MAX_UNUSED];
-}
+    // Blocks and the ends of streams are marked by 48-bit magic numbers (BCD pi and sqrt(pi)), not aligned to bytes
+    constexpr std::uint64_t block_magic = 0x314159265359ull;
+    constexpr std::uint64_t end_magic = 0x177245385090ull;
+    constexpr std::uint64_t magic_mask = (1ull << 48) - 1;
 
-namespace bz2_connector {
-    std::string read_all(char const * filename)
-    {
-        using namespace detail;
+    /// Bit string, its first bit the highest bit of the first byte. Bits past the size are zeros.
+    struct bits {
+        std::vector<UChar> bytes;
+        std::uint64_t size = 0;
 
-        if (!fileExists(filename))
-            throw std::runtime_error("bz2_connector: No file found.");
-        FILE *zStream = fopen (filename, "rb" );
+        void clear() noexcept {
+            bytes.clear();
+            size = 0;
+        }
 
-        BZFILE* bzf;
+        /// Appends the lowest count bits of value, the highest of them first
+        void append(std::uint64_t value, unsigned count) {
+            while (count) {
+                auto const used = static_cast<unsigned>(size % 8);
+                if (!used)
+                    bytes.push_back(0);
+                auto const n = std::min(count, 8 - used);
+                bytes.back() |= static_cast<UChar>(((value >> (count - n)) & ((1u << n) - 1)) << (8 - used - n));
+                size += n;
+                count -= n;
+            }
+        }
 
-        Int32   verbosity = 0;
-        Int32   bzerr, bzerr_dummy, ret, nread, streamNo, i;
+        void append(bits const & other) {
+            for (std::uint64_t i = 0; i * 8 < other.size; ++i) {
+                auto const n = static_cast<unsigned>(std::min<std::uint64_t>(8, other.size - i * 8));
+                append(other.bytes[i] >> (8 - n), n);
+            }
+        }
 
-        Int32   nUnused;
-        void*   unusedTmpV;
-        UChar*  unusedTmp;
+        [[nodiscard]] std::uint64_t read(std::uint64_t at, unsigned count) const noexcept {
+            std::uint64_t value = 0;
+            for (auto i = at; i != at + count; ++i)
+                value = (value << 1) | ((bytes[i / 8] >> (7 - i % 8)) & 1);
+            return value;
+        }
+    };
 
-        nUnused = 0;
-        streamNo = 0;
+    /// Bits a block of a stream of a level (blocks of up to level x 100 KB) can't go beyond: a code of at most 20 bits
+    /// for each byte and for the end of the block, 18002 selectors of up to 6 bits, 6 coding tables of 258 lengths, the
+    /// mapping table, the counts and the header of the block
+    constexpr std::uint64_t max_block_bits(unsigned level) noexcept {
+        return 20 * (level * 100000ull + 1) + 18002 * 6 + 6 * (5 + 258 * 41) + 17 * 16 + 3 + 15 + 48 + 32 + 1 + 24;
+    }
 
-        std::string str;
+    /// Cuts the streams of a .bz2 file at the magic numbers, wherever they start, into segments. A block goes from a
+    /// block magic to the next magic number, the bits after an end magic up to the next magic number are a segment
+    /// too. A block is a whole block indeed unless the magic number after it happens to be within its compressed data:
+    /// the segments after it are then part of it.
+    class block_scanner {
+        FILE * file;
+        std::vector<UChar> in;          // bytes of the file from in_offset on
+        std::uint64_t in_offset = 0;
+        bool eof = false;
+        bool started = false;           // the stream header at the start of the file is checked
+        bool done = false;
+        std::uint64_t at = 0;           // bit the next segment starts at, with a magic number
+        bool at_end = false;            // which one
+        bool new_stream = true;         // the next block starts a stream
+        unsigned stream_level = 9;
+        int stream_count = 0;
+
+        // Shifts a magic number may start at within a byte, by the value of the next byte, which it covers wholly:
+        // the lower half for the block magic, the upper half for the end magic
+        constexpr static auto shifts = [] {
+            struct { std::uint16_t v[256]; } t {};
+            for (auto s = 0u; s != 8; ++s) {
+                t.v[(block_magic >> (32 + s)) & 0xff] |= 1u << s;
+                t.v[(end_magic >> (32 + s)) & 0xff] |= 1u << (8 + s);
+            }
+            return t;
+        }();
+
+        /// Reads more of the file, dropping the bytes before keep. False at the end of the file.
+        bool refill(std::uint64_t keep) {
+            if (eof)
+                return false;
+            auto const drop = std::min<std::uint64_t>(keep / 8 > in_offset ? keep / 8 - in_offset : 0, in.size());
+            in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(drop));
+            in_offset += drop;
+            constexpr std::size_t chunk = 1 << 20;
+            auto const size = in.size();
+            in.resize(size + chunk);
+            auto const got = fread(in.data() + size, 1, chunk, file);
+            in.resize(size + got);
+            if (got != chunk) {
+                if (ferror(file))
+                    throw std::runtime_error("bz2_connector: decompress: I/O error.");
+                eof = true;
+            }
+            return got != 0;
+        }
 
-        SET_BINARY_MODE(zStream)
+        /// Bit position of the first magic number at or after bit, 0 if there are none. is_end tells which one it is.
+        /// The bits from keep on are kept for extract(), as long as they may be a segment of a block.
+        std::uint64_t find(std::uint64_t bit, std::uint64_t keep, bool & is_end) {
+            for (auto p = bit / 8 - in_offset;; ++p) {
+                // Eight bytes from p hold a magic number starting within byte p
+                while (p + 8 > in.size()) {
+                    auto const before = in_offset;
+                    auto const pos = (in_offset + p) * 8;
+                    auto const reach = max_block_bits(9) + 64;
+                    if (!refill(std::max(std::min(keep, pos), pos > reach ? pos - reach : 0)))
+                        return 0;
+                    p -= in_offset - before;
+                }
+                auto const candidates = shifts.v[in[p + 1]];
+                if (!candidates)
+                    continue;
+                std::uint64_t w = 0;
+                for (auto i = 0u; i != 8; ++i)
+                    w = (w << 8) | in[p + i];
+                for (auto s = 0u; s != 8; ++s) {
+                    auto const at = (in_offset + p) * 8 + s;
+                    if (at < bit)
+                        continue;
+                    auto const value = (w >> (16 - s)) & magic_mask;
+                    if ((candidates >> s & 1) && value == block_magic) {
+                        is_end = false;
+                        return at;
+                    }
+                    if ((candidates >> (8 + s) & 1) && value == end_magic) {
+                        is_end = true;
+                        return at;
+                    }
+                }
+            }
+        }
 
-        Bool smallMode = false;
+        /// Copies the bits [begin, end) of the file to block, all of them within the bytes read
+        void extract(std::uint64_t begin, std::uint64_t end, bits & block) const {
+            block.clear();
+            auto const first = begin / 8 - in_offset;
+            auto const shift = static_cast<unsigned>(begin % 8);
+            auto const size = (end - begin + 7) / 8;
+            block.bytes.resize(size);
+            for (std::uint64_t i = 0; i != size; ++i) {
+                unsigned const hi = in[first + i];
+                unsigned const lo = first + i + 1 < in.size() ? in[first + i + 1] : 0;
+                block.bytes[i] = static_cast<UChar>(((hi << 8 | lo) >> (8 - shift)) & 0xff);
+            }
+            block.size = end - begin;
+            if (auto const tail = block.size % 8)
+                block.bytes.back() &= static_cast<UChar>(0xff << (8 - tail));
+        }
 
-        if (ferror(zStream))
-            goto errhandler_io;
+    public:
+        enum class segment {
+            block,
+            end,
+            long_end        // after an end magic, too long to be a part of a block: left empty
+        };
+
+        explicit block_scanner(FILE * file) : file(file) {}
+
+        /// Next segment, false after the last one
+        bool next(bits & piece, segment & kind) {
+            if (!started) {
+                // Not a bzip2 file unless it starts with a stream header
+                while (in.size() < 4 && refill(0)) {}
+                if (in.size() < 4 || in[0] != 'B' || in[1] != 'Z' || in[2] != 'h' || in[3] < '1' || in[3] > '9')
+                    throw data_error("bz2_connector: decompress: data error.");
+                stream_level = in[3] - '0';
+                started = true;
+                at = find(32, 32, at_end);
+                done = !at;
+            }
+            if (done)
+                return false;
+
+            bool next_end;
+            auto const next_at = find(at + 48, at, next_end);
+            // a block without a magic number after it goes on to the end of the file: truncated, it won't decode
+            auto const end = next_at ? next_at : (in_offset + in.size()) * 8;
+            if (!at_end) {
+                if (end - at > max_block_bits(9))
+                    throw data_error("bz2_connector: decompress: data error.");
+                if (std::exchange(new_stream, false)) {
+                    ++stream_count;
+                    // the header of a stream, aligned to a byte, ends with its level right before its first block
+                    if (auto const level = at / 8 - 1; !(at % 8) && level >= in_offset && in[level - in_offset] >= '1' && in[level - in_offset] <= '9')
+                        stream_level = in[level - in_offset] - '0';
+                }
+                extract(at, end, piece);
+                kind = segment::block;
+            } else {
+                new_stream = true;
+                if (end - at > max_block_bits(9)) {
+                    piece.clear();
+                    kind = segment::long_end;
+                } else {
+                    extract(at, end, piece);
+                    kind = segment::end;
+                }
+            }
+            done = !next_at;
+            at = next_at;
+            at_end = next_end;
+            return true;
+        }
 
-        while (True) {
+        void rewind() {
+            std::rewind(file);
+            in.clear();
+            in_offset = 0;
+            eof = false;
+            started = done = false;
+            at = 0;
+            new_stream = true;
+            stream_level = 9;
+            stream_count = 0;
+        }
 
-            bzf = BZ2_bzReadOpen (&bzerr, zStream, verbosity, (int)smallMode, unused, nUnused);
+        /// Level of the stream of the last block
+        [[nodiscard]] unsigned level() const noexcept { return stream_level; }
+
+        [[nodiscard]] int streams() const noexcept { return stream_count; }
+    };
+
+    /// Decodes a block, made a stream of its own, into out. False if it isn't a whole valid block.
+    inline bool decode(bits const & block, std::vector<char> & out) {
+        out.clear();
+        if (block.size < 80)
+            return false;
+        // "BZh9" holds any block. The stream's CRC of a single block is the CRC of the block, stored after its magic.
+        bits stream;
+        stream.bytes.reserve(block.bytes.size() + 16);
+        stream.bytes = {'B', 'Z', 'h', '9'};
+        stream.bytes.insert(stream.bytes.end(), block.bytes.begin(), block.bytes.end());
+        stream.size = 32 + block.size;
+        stream.append(end_magic, 48);
+        stream.append(block.read(48, 32), 32);
+
+        bz_stream strm {};
+        if (BZ2_bzDecompressInit(&strm, 0, 0) != BZ_OK)
+            return false;
+        strm.next_in = reinterpret_cast<char *>(stream.bytes.data());
+        strm.avail_in = static_cast<unsigned>(stream.bytes.size());
+        out.resize(std::max<std::size_t>(out.capacity(), 1 << 20));
+        std::size_t produced = 0;
+        auto ret = BZ_OK;
+        while (ret == BZ_OK) {
+            if (produced == out.size())
+                out.resize(out.size() * 2);
+            strm.next_out = out.data() + produced;
+            strm.avail_out = static_cast<unsigned>(out.size() - produced);
+            ret = BZ2_bzDecompress(&strm);
+            produced = out.size() - strm.avail_out;
+            if (ret == BZ_OK && !strm.avail_in && strm.avail_out)
+                ret = BZ_UNEXPECTED_EOF;
+        }
+        BZ2_bzDecompressEnd(&strm);
+        out.resize(produced);
+        return ret == BZ_STREAM_END;
+    }
+}
+
+namespace bz2_connector {
+
+    /// Blocks decoded by threads, handed out in the order of the file
+    struct stream_reader::pool {
+        struct job {
+            detail::bits block;
+            std::vector<detail::bits> tails;    // segments after end magics up to the next block
+            bool cut = false;                   // a segment after the tails can't be a part of a block
+            unsigned level = 9;
+            std::vector<char> out;
+            bool done = false;
+            bool ok = false;
+        };
+
+        detail::block_scanner scanner;
+        std::size_t depth;                          // blocks decoded ahead of the one handed out
+        std::deque<std::unique_ptr<job>> jobs;      // in the order of the file
+        std::deque<job *> pending;                  // yet to be decoded
+        std::unique_ptr<job> current;               // handed out
+        std::vector<std::vector<char>> spare;       // buffers to decode into again
+        std::optional<detail::bits> ahead;          // block found after the tails of the last one scanned
+        unsigned ahead_level = 9;
+        std::mutex m;
+        std::condition_variable work;
+        std::condition_variable done;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+
+        pool(FILE * file, unsigned threads) : scanner(file), depth(2 * threads) {
+            try {
+                for (auto i = 0u; i != threads; ++i)
+                    workers.emplace_back([this] { decode_blocks(); });
+            } catch (...) {
+                stop();
+                throw;
+            }
+        }
+
+        ~pool() {
+            stop();
+        }
 
-            if (bzf == nullptr || bzerr != BZ_OK)
-                goto errhandler;
-            streamNo++;
+        void stop() noexcept {
+            {
+                std::lock_guard lock (m);
+                stopping = true;
+            }
+            work.notify_all();
+            for (auto & w : workers)
+                w.join();
+            workers.clear();
+        }
 
-            while (bzerr == BZ_OK) {
-                nread = BZ2_bzRead ( &bzerr, bzf, obuf, obuf_size);
-                if (bzerr == BZ_DATA_ERROR_MAGIC)
-                    goto trycat;
-                if ((bzerr == BZ_OK || bzerr == BZ_STREAM_END) && nread > 0)
-                    str += std::string{obuf, obuf + nread};
+        void decode_blocks() {
+            for (;;) {
+                job * j;
+                {
+                    std::unique_lock lock (m);
+                    work.wait(lock, [&] { return stopping || !pending.empty(); });
+                    if (stopping)
+                        return;
+                    j = pending.front();
+                    pending.pop_front();
+                }
+                bool ok = false;
+                try {
+                    ok = detail::decode(j->block, j->out);
+                } catch (...) {}
+                {
+                    std::lock_guard lock (m);
+                    j->ok = ok;
+                    j->done = true;
+                }
+                done.notify_all();
             }
-            if (bzerr != BZ_STREAM_END)
-                goto errhandler;
+        }
 
-            BZ2_bzReadGetUnused ( &bzerr, bzf, &unusedTmpV, &nUnused );
-            if (bzerr != BZ_OK)
-                throw std::runtime_error("bz2_connector: decompress: BZ2_bzReadGetUnused.");
+        void wait(job const & j) {
+            std::unique_lock lock (m);
+            done.wait(lock, [&] { return j.done; });
+        }
 
-            unusedTmp = (UChar*)unusedTmpV;
-            for (i = 0; i < nUnused; i++)
-                unused[i] = unusedTmp[i];
+        std::unique_ptr<job> scan() {
+            using segment = detail::block_scanner::segment;
+            auto j = std::make_unique<job>();
+            auto kind = segment::block;
+            if (ahead) {
+                j->block = std::move(*ahead);
+                j->level = ahead_level;
+                ahead.reset();
+            } else {
+                // end magics before any block end empty streams
+                do {
+                    if (!scanner.next(j->block, kind))
+                        return {};
+                } while (kind != segment::block);
+                j->level = scanner.level();
+            }
+            for (detail::bits piece; scanner.next(piece, kind);) {
+                if (kind == segment::block) {
+                    ahead = std::move(piece);
+                    ahead_level = scanner.level();
+                    break;
+                }
+                j->cut = j->cut || kind == segment::long_end;
+                if (!j->cut)
+                    j->tails.push_back(std::move(piece));
+            }
+            if (!spare.empty()) {
+                j->out = std::move(spare.back());
+                spare.pop_back();
+            }
+            return j;
+        }
 
-            BZ2_bzReadClose ( &bzerr, bzf );
-            if (bzerr != BZ_OK)
-                throw std::runtime_error("bz2_connector: decompress: BZ2_bzReadClose.");
+        std::string_view read() {
+            if (current) {
+                spare.push_back(std::move(current->out));
+                current.reset();
+            }
+            while (jobs.size() < depth) {
+                auto j = scan();
+                if (!j)
+                    break;
+                {
+                    std::lock_guard lock (m);
+                    pending.push_back(j.get());
+                }
+                jobs.push_back(std::move(j));
+                work.notify_one();
+            }
+            if (jobs.empty())
+                return {};
+
+            auto front = std::move(jobs.front());
+            jobs.pop_front();
+            wait(*front);
+            while (!front->ok) {
+                // A magic number found within the compressed data cut the block short: it goes on with what follows,
+                // as long as it may be a block. Damaged data ends up there.
+                if (!front->tails.empty()) {
+                    front->block.append(front->tails.front());
+                    front->tails.erase(front->tails.begin());
+                } else {
+                    std::unique_ptr<job> next;
+                    if (front->cut)
+                        throw data_error("bz2_connector: decompress: data error.");
+                    if (!jobs.empty()) {
+                        next = std::move(jobs.front());
+                        jobs.pop_front();
+                        wait(*next);
+                    } else if (!(next = scan()))
+                        throw data_error("bz2_connector: decompress: data error.");
+                    front->block.append(next->block);
+                    front->tails = std::move(next->tails);
+                    front->cut = next->cut;
+                    spare.push_back(std::move(next->out));
+                }
+                if (front->block.size > detail::max_block_bits(front->level))
+                    throw data_error("bz2_connector: decompress: data error.");
+                front->ok = detail::decode(front->block, front->out);
+            }
+            current = std::move(front);
+            return {current->out.data(), current->out.size()};
+        }
 
-            if (nUnused == 0 && myfeof(zStream))
-                break;
+        void rewind() {
+            for (auto & j : jobs)
+                wait(*j);
+            jobs.clear();
+            current.reset();
+            ahead.reset();
+            scanner.rewind();
+        }
+    };
+
+    struct stream_reader::state {
+        FILE * zStream = nullptr;
+        BZFILE * bzf = nullptr;
+        Int32 streamNo = 0;
+        Int32 nUnused = 0;
+        Bool done = False;
+        std::unique_ptr<UChar[]> obuf {new UChar[detail::obuf_size]};
+        std::unique_ptr<UChar[]> unused {new UChar[BZ_MAX_UNUSED]};
+        std::unique_ptr<stream_reader::pool> blocks;
+
+        void close_stream() noexcept {
+            Int32 bzerr_dummy;
+            if (bzf != nullptr)
+                BZ2_bzReadClose(&bzerr_dummy, bzf);
+            bzf = nullptr;
         }
 
-        if (ferror(zStream))
-            goto errhandler_io;
+        ~state() {
+            blocks.reset();
+            close_stream();
+            if (zStream != nullptr)
+                fclose(zStream);
+        }
+    };
 
-        ret = fclose ( zStream );
-        if (ret == EOF)
-            goto errhandler_io;
+    stream_reader::stream_reader(char const * filename, unsigned threads) : s(std::make_unique<state>()) {
+        if (!detail::fileExists(filename))
+            throw std::runtime_error("bz2_connector: No file found.");
+        s->zStream = fopen(filename, "rb");
+        if (s->zStream == nullptr)
+            throw std::runtime_error("bz2_connector: decompress: I/O error.");
+        SET_BINARY_MODE(s->zStream)
+        if (!threads)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        if (threads > 1)
+            s->blocks = std::make_unique<pool>(s->zStream, threads);
+    }
 
-        return str;
+    stream_reader::stream_reader(stream_reader &&) noexcept = default;
+    stream_reader & stream_reader::operator=(stream_reader &&) noexcept = default;
+    stream_reader::~stream_reader() = default;
 
-        trycat:
-        errhandler:
+    std::string_view stream_reader::read() {
+        using namespace detail;
 
-        BZ2_bzReadClose ( &bzerr_dummy, bzf );
-        switch (bzerr) {
-            case BZ_CONFIG_ERROR:
-            case BZ_IO_ERROR:
-                errhandler_io:
-                break;
-            case BZ_DATA_ERROR:
-            case BZ_MEM_ERROR:
-            case BZ_UNEXPECTED_EOF:
-            case BZ_DATA_ERROR_MAGIC:
-                if (zStream != stdin)
-                    fclose(zStream);
+        if (s->blocks)
+            return s->blocks->read();
+
+        while (!s->done) {
+            if (s->bzf == nullptr) {
+                if (ferror(s->zStream))
+                    throw std::runtime_error("bz2_connector: decompress: I/O error.");
+                if (s->streamNo > 0 && s->nUnused == 0 && myfeof(s->zStream)) {
+                    s->done = True;
+                    break;
+                }
+                Int32 bzerr;
+                s->bzf = BZ2_bzReadOpen(&bzerr, s->zStream, 0, 0, s->unused.get(), s->nUnused);
+                if (s->bzf == nullptr || bzerr != BZ_OK) {
+                    s->close_stream();
+                    throw std::runtime_error("bz2_connector: decompress: BZ2_bzReadOpen.");
+                }
+                s->streamNo++;
+            }
+
+            Int32 bzerr;
+            auto const nread = BZ2_bzRead(&bzerr, s->bzf, s->obuf.get(), obuf_size);
+            if (bzerr == BZ_OK) {
+                if (nread > 0)
+                    return {reinterpret_cast<char const *>(s->obuf.get()), static_cast<std::size_t>(nread)};
+                continue;
+            }
+
+            if (bzerr == BZ_STREAM_END) {
+                // The bytes read past the end of this stream start the next one
+                void * unusedTmpV;
+                BZ2_bzReadGetUnused(&bzerr, s->bzf, &unusedTmpV, &s->nUnused);
+                if (bzerr != BZ_OK)
+                    throw std::runtime_error("bz2_connector: decompress: BZ2_bzReadGetUnused.");
+                std::copy_n(static_cast<UChar const *>(unusedTmpV), s->nUnused, s->unused.get());
+                s->close_stream();
+                if (nread > 0)
+                    return {reinterpret_cast<char const *>(s->obuf.get()), static_cast<std::size_t>(nread)};
+                continue;
+            }
 
-                if (streamNo == 1)
-                    return {};
-                else
-                    return str;
-            default:
-                throw std::runtime_error("bz2_connector: decompress: unexpected error.");
+            s->close_stream();
+            switch (bzerr) {
+                case BZ_DATA_ERROR_MAGIC:
+                    // Not a bzip2 stream: garbage after the last stream is ignored
+                    if (s->streamNo > 1) {
+                        s->done = True;
+                        break;
+                    }
+                    [[fallthrough]];
+                case BZ_DATA_ERROR:
+                case BZ_UNEXPECTED_EOF:
+                    throw data_error("bz2_connector: decompress: data error.");
+                case BZ_MEM_ERROR:
+                    throw std::runtime_error("bz2_connector: decompress: out of memory.");
+                case BZ_IO_ERROR:
+                    throw std::runtime_error("bz2_connector: decompress: I/O error.");
+                default:
+                    throw std::runtime_error("bz2_connector: decompress: unexpected error.");
+            }
         }
+        return {};
+    }
 
-        throw std::runtime_error("bz2_connector: decompress:end");
+    void stream_reader::rewind() {
+        if (s->blocks) {
+            s->blocks->rewind();
+            return;
+        }
+        s->close_stream();
+        std::rewind(s->zStream);
+        s->streamNo = 0;
+        s->nUnused = 0;
+        s->done = False;
+    }
 
+    int stream_reader::streams() const noexcept {
+        return s->blocks ? s->blocks->scanner.streams() : s->streamNo;
     }
-}
 
+    std::string read_all(char const * filename)
+    {
+        stream_reader reader(filename);
+        std::string str;
+        try {
+            for (auto piece = reader.read(); !piece.empty(); piece = reader.read())
+                str.append(piece);
+        } catch (data_error const &) {
+            // A damaged first stream gives nothing, a damaged later one ends the data
+            if (reader.streams() == 1)
+                return {};
+        }
+        return str;
+    }
+}
@@ -1,6 +1,40 @@
 #pragma once
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace bz2_connector {
     std::string read_all(char const * filename);
+
+    /// Damaged or truncated compressed data
+    struct data_error : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    /// Decompresses a .bz2 file piece by piece, so that it is never inflated as a whole. Concatenated streams are read
+    /// one after another, trailing garbage after a stream is ignored.
+    ///
+    /// With more than one thread the blocks of the streams, independent of each other, are found by their magic
+    /// numbers and decoded by that many threads a few blocks ahead, then handed out in order a block at a time.
+    class stream_reader {
+    public:
+        /// threads: 0 for as many as the hardware runs at once, 1 to decode in the calling thread
+        explicit stream_reader(char const * filename, unsigned threads = 0);
+        stream_reader(stream_reader &&) noexcept;
+        stream_reader & operator=(stream_reader &&) noexcept;
+        ~stream_reader();
+
+        /// Next piece of the decompressed data, valid until the next call. Empty at the end of the file.
+        std::string_view read();
+        /// Starts over from the beginning of the file
+        void rewind();
+        /// Number of streams opened so far
+        [[nodiscard]] int streams() const noexcept;
+
+    private:
+        struct pool;
+        struct state;
+        std::unique_ptr<state> s;
+    };
 }
@@ -52,6 +52,8 @@ namespace mio {
     const static file_handle_type invalid_handle = INVALID_HANDLE_VALUE;
 
     constexpr int read_access_mode = 0;
+    /// Private mapping: the pages are writable, and written ones are copies never going to the file
+    constexpr int copy_on_write_access_mode = 1;
 
     struct ro_mmap
     {
@@ -69,6 +71,8 @@ namespace mio {
         pointer data_ = nullptr;
         size_type length_ = 0;
         size_type mapped_length_ = 0;
+        size_type offset_ = 0;
+        bool private_ = false;
 
         handle_type file_handle_ = INVALID_HANDLE_VALUE;
 #ifdef _WIN32
@@ -91,6 +95,8 @@ namespace mio {
             std::swap(data_,o.data_);
             std::swap(length_,o.length_);
             std::swap(mapped_length_, o.mapped_length_);
+            std::swap(offset_, o.offset_);
+            std::swap(private_, o.private_);
             std::swap(file_handle_,o.file_handle_);
 #ifdef _WIN32
             std::swap(file_mapping_handle_,o.file_mapping_handle_);
@@ -111,6 +117,7 @@ namespace mio {
         [[nodiscard]] bool is_open() const noexcept { return file_handle_ != invalid_handle; }
         [[nodiscard]] bool empty() const noexcept { return length() == 0; }
         [[nodiscard]] inline bool is_mapped() const noexcept;
+        [[nodiscard]] bool is_private() const noexcept { return private_; }
         [[nodiscard]] size_type size() const noexcept { return length(); }
         [[nodiscard]] size_type length() const noexcept { return length_; }
         [[nodiscard]] size_type mapping_offset() const noexcept
@@ -143,6 +150,9 @@ namespace mio {
 
         inline void unmap();
 
+        /// Maps the same bytes anew privately (copy-on-write), so they can be written to without touching the file
+        inline void remap_private(std::error_code& error);
+
     private:
         [[nodiscard]] const_pointer get_mapping_start() const noexcept
         {
@@ -381,7 +391,7 @@ namespace mio {
         }
 
         inline mmap_context memory_map(const file_handle_type file_handle, const int64_t offset,
-                                       const int64_t length, const int /*access_mode mode*/, std::error_code& error)
+                                       const int64_t length, const int mode, std::error_code& error)
         {
             const int64_t aligned_offset = make_offset_page_aligned(offset);
             const int64_t length_to_map = offset - aligned_offset + length;
@@ -390,7 +400,7 @@ namespace mio {
             const auto file_mapping_handle = ::CreateFileMapping(
                     file_handle,
                     nullptr,
-                    PAGE_READONLY,
+                    mode == copy_on_write_access_mode ? PAGE_WRITECOPY : PAGE_READONLY,
                     win::int64_high(max_file_size),
                     win::int64_low(max_file_size),
                     nullptr);
@@ -401,7 +411,7 @@ namespace mio {
             }
             char* mapping_start = static_cast<char*>(::MapViewOfFile(
                     file_mapping_handle,
-                    FILE_MAP_READ,
+                    mode == copy_on_write_access_mode ? FILE_MAP_COPY : FILE_MAP_READ,
                     win::int64_high(aligned_offset),
                     win::int64_low(aligned_offset),
                     length_to_map));
@@ -416,8 +426,8 @@ namespace mio {
             char* mapping_start = static_cast<char*>(::mmap(
                     nullptr, // Don't give hint as to where to map.
                     length_to_map,
-                    PROT_READ,
-                    MAP_SHARED,
+                    mode == copy_on_write_access_mode ? PROT_READ | PROT_WRITE : PROT_READ,
+                    mode == copy_on_write_access_mode ? MAP_PRIVATE : MAP_SHARED,
                     file_handle,
                     aligned_offset));
             if(mapping_start == MAP_FAILED)
@@ -500,12 +510,36 @@ namespace mio {
             data_ = reinterpret_cast<pointer>(ctx.data);
             length_ = ctx.length;
             mapped_length_ = ctx.mapped_length;
+            offset_ = offset;
+            private_ = false;
 #ifdef _WIN32
             file_mapping_handle_ = ctx.file_mapping_handle;
 #endif
         }
     }
 
+    void ro_mmap::remap_private(std::error_code& error)
+    {
+        error.clear();
+        if(!is_open() || private_) { return; }
+        const auto ctx = detail::memory_map(file_handle_, offset_, length_, copy_on_write_access_mode, error);
+        if(error)
+        {
+            return;
+        }
+        // Drop the shared mapping only, the file stays open
+#ifdef _WIN32
+        ::UnmapViewOfFile(get_mapping_start());
+        ::CloseHandle(file_mapping_handle_);
+        file_mapping_handle_ = ctx.file_mapping_handle;
+#else // POSIX
+        ::munmap(const_cast<pointer>(get_mapping_start()), mapped_length_);
+#endif
+        data_ = reinterpret_cast<pointer>(ctx.data);
+        mapped_length_ = ctx.mapped_length;
+        private_ = true;
+    }
+
     void ro_mmap::unmap()
     {
         if(!is_open()) { return; }
@@ -530,7 +564,8 @@ namespace mio {
         }
 
         data_ = nullptr;
-        length_ = mapped_length_ = 0;
+        length_ = mapped_length_ = offset_ = 0;
+        private_ = false;
         file_handle_ = invalid_handle;
 #ifdef _WIN32
         file_mapping_handle_ = invalid_handle;
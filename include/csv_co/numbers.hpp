@@ -0,0 +1,247 @@
+///
+/// \file   include/csv_co/numbers.hpp
+/// \author wiluite
+/// \brief  Locale-free number parsing for CSV_co cell casts.
+///
+/// Integers are parsed eight digits at a time within a 64-bit word (SWAR), so no particular instruction set is needed
+/// and nothing is to be dispatched at run time. Long doubles are scanned by the fast_float machinery and converted with
+/// a single rounding whenever it is exact to do so.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cfloat>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+
+#ifndef _MSC_VER
+    #include "external/fast_float/fast_float.h"
+#endif
+
+#if defined(_MSC_VER)
+    #define CSV_CO_NOINLINE __declspec(noinline)
+#else
+    #define CSV_CO_NOINLINE __attribute__((noinline))
+#endif
+
+namespace csv_co::numbers {
+
+    namespace detail {
+        constexpr std::uint64_t ones = 0x0101010101010101ull;
+
+        constexpr std::uint64_t pow10[] {1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull};
+
+        /// Up to eight bytes at p (n of them if fewer are left), the first one in the lowest byte, zeros past the end
+        inline std::uint64_t load8(char const * p, std::size_t n) noexcept {
+            std::uint64_t w = 0;
+            if constexpr (std::endian::native == std::endian::little) {
+                if (n >= 8) {
+                    std::memcpy(&w, p, 8);
+                    return w;
+                }
+            }
+            for (std::size_t i = 0; i != (n < 8 ? n : 8); ++i)
+                w |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+            return w;
+        }
+
+        /// Number of leading bytes of w that are decimal digits
+        inline unsigned leading_digits(std::uint64_t w) noexcept {
+            // A carry out of a byte ≥ 0xfa may spoil the next one, but such a byte isn't a digit already
+            auto const non_digits = ((w & (0xf0 * ones)) ^ (0x30 * ones)) | (((w + 0x06 * ones) & (0xf0 * ones)) ^ (0x30 * ones));
+            return non_digits ? static_cast<unsigned>(std::countr_zero(non_digits)) / 8 : 8;
+        }
+
+        /// Value of the eight digits of w, the first (lowest) byte being the most significant digit
+        inline std::uint32_t value8(std::uint64_t w) noexcept {
+            w -= 0x30 * ones;
+            w = (w * 10) + (w >> 8);
+            w = (((w & 0x000000ff000000ff) * (100 + (1000000ull << 32))) + (((w >> 16) & 0x000000ff000000ff) * (1 + (10000ull << 32)))) >> 32;
+            return static_cast<std::uint32_t>(w);
+        }
+
+        /// Accumulates digits at p into v eight at a time while eight bytes are left, returns where it stopped.
+        /// Kept out of line: short numbers, the most frequent ones, don't need its registers.
+        CSV_CO_NOINLINE inline char const * parse8(char const * p, char const * last, std::uint64_t & v) noexcept {
+            std::uint64_t r = v;
+            do {
+                auto const w = load8(p, 8);
+                auto const k = leading_digits(w);
+                if (!k)
+                    break;
+                // Put '0's before the digits so as to make them eight
+                auto const digits = k == 8 ? w : (w << (8 * (8 - k))) | ((0x30 * ones) >> (8 * k));
+                r = r * pow10[k] + value8(digits);
+                p += k;
+                if (k != 8)
+                    break;
+            } while (last - p >= 8);
+            v = r;
+            return p;
+        }
+    }
+
+    /// Parses a decimal integer at [first, last) exactly as std::from_chars() does: a minus for signed types only,
+    /// then the longest run of digits. invalid_argument if there are no digits, result_out_of_range if the value
+    /// doesn't fit T. The value is left intact on errors.
+    template <typename T>
+    inline std::from_chars_result parse_integer(char const * first, char const * last, T & value) noexcept
+        requires (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(std::uint64_t)) {
+
+        auto p = first;
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>)
+            if (p != last && *p == '-')
+                negative = true, ++p;
+
+        auto const digits_begin = p;
+
+        std::uint64_t v = 0;
+        // Eight digits at a time as long as eight bytes are there to be loaded, then one at a time
+        if (last - p >= 8)
+            p = detail::parse8(p, last, v);
+        for (unsigned d; p != last && (d = static_cast<unsigned char>(*p - '0')) < 10; ++p)
+            v = v * 10 + d;
+
+        // Up to 19 digits can't overflow 64 bits, more digits (leading zeros perhaps) are taken again with care
+        if (p - digits_begin > 19) {
+            v = 0;
+            for (auto q = digits_begin; q != p; ++q) {
+                auto const d = static_cast<unsigned>(*q - '0');
+                if (v > (std::numeric_limits<std::uint64_t>::max() - d) / 10)
+                    return {p, std::errc::result_out_of_range};
+                v = v * 10 + d;
+            }
+        }
+
+        if (p == digits_begin)
+            return {first, std::errc::invalid_argument};
+
+        using unsigned_type = std::make_unsigned_t<T>;
+        auto const limit = static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + negative;
+        if (v > limit)
+            return {p, std::errc::result_out_of_range};
+
+        value = static_cast<T>(negative ? static_cast<unsigned_type>(0 - v) : static_cast<unsigned_type>(v));
+        return {p, std::errc()};
+    }
+
+#ifndef _MSC_VER
+    namespace detail {
+        /// Greatest k such that 10^k, and so any integer times 10^-k, is exactly representable in long double
+        constexpr int exact_pow10_ld = [] {
+            // 10^k = 5^k * 2^k is exact as long as 5^k fits the significand
+            int k = 0;
+            for (long double five = 5; five < std::numeric_limits<std::uint64_t>::max() && std::bit_width(static_cast<std::uint64_t>(five)) <= LDBL_MANT_DIG; five *= 5)
+                ++k;
+            return k;
+        }();
+
+        constexpr auto pow10_ld = [] {
+            struct { long double v[exact_pow10_ld + 1]; } t {};
+            t.v[0] = 1;
+            for (int k = 1; k <= exact_pow10_ld; ++k)
+                t.v[k] = t.v[k - 1] * 10;
+            return t;
+        }();
+
+        /// Terminated text for the C library: on the stack unless it is longer than numbers usually are
+        class c_text {
+            char local [128];
+            std::unique_ptr<char[]> heap;
+            char * text;
+        public:
+            explicit c_text(std::size_t size) : text(size < sizeof local ? local : (heap = std::make_unique<char[]>(size + 1)).get()) {}
+            c_text(c_text const &) = delete;
+            c_text & operator=(c_text const &) = delete;
+            char * data() noexcept { return text; }
+        };
+
+        /// The long double nearest to a decimal string by strtold(). The string is rewritten as an integer followed by a
+        /// decimal exponent, so the decimal point of the current locale doesn't matter.
+        inline std::from_chars_result strtold_c(fast_float::parsed_number_string const & n, char const * first, long double & value) noexcept {
+            // The explicit exponent standing between the digits and where the number ends
+            auto const digits_end = n.fraction.ptr ? n.fraction.ptr + n.fraction.len() : n.integer.ptr + n.integer.len();
+            long long exp10 = 0;
+            if (digits_end != n.lastmatch) {
+                auto q = digits_end + 1;
+                bool const negative = *q == '-';
+                q += (*q == '-' || *q == '+');
+                for (; q != n.lastmatch; ++q)
+                    if (exp10 < 100000000)
+                        exp10 = exp10 * 10 + (*q - '0');
+                exp10 = negative ? -exp10 : exp10;
+            }
+            exp10 -= static_cast<long long>(n.fraction.len());
+
+            // sign, digits, 'e' and the exponent
+            c_text text (1 + n.integer.len() + n.fraction.len() + 1 + std::numeric_limits<long long>::digits10 + 2);
+            auto p = text.data();
+            *p = '-';
+            p += n.negative;
+            p = std::copy_n(n.integer.ptr, n.integer.len(), p);
+            if (n.fraction.ptr)
+                p = std::copy_n(n.fraction.ptr, n.fraction.len(), p);
+            *p++ = 'e';
+            *std::to_chars(p, p + std::numeric_limits<long long>::digits10 + 2, exp10).ptr = '\0';
+
+            auto const saved_errno = errno;
+            errno = 0;
+            value = std::strtold(text.data(), nullptr);
+            auto const range_error = errno == ERANGE;
+            errno = saved_errno;
+            return {n.lastmatch, range_error ? std::errc::result_out_of_range : std::errc()};
+        }
+    }
+
+    /// Parses a long double at [first, last) the way strtold() does in the "C" locale: leading white space, a sign, a
+    /// decimal number, or an infinity, a NaN, a hexadecimal number. Trailing characters are ignored. invalid_argument if
+    /// there is no number, result_out_of_range if it is out of the range of long double.
+    inline std::from_chars_result parse_long_double(char const * first, char const * last, long double & value) noexcept {
+        auto p = first;
+        while (p != last && (*p == ' ' || (*p >= '\t' && *p <= '\r')))
+            ++p;
+        auto const number = p;
+        bool const plus = p != last && *p == '+';
+        p += plus;
+
+        auto const signed_once = p != last && *p != '+' && !(plus && *p == '-');
+        auto const n = signed_once ? fast_float::parse_number_string(p, last, fast_float::parse_options{}) : fast_float::parsed_number_string{};
+        bool const hex = n.valid && n.lastmatch - n.integer.ptr == 1 && *n.integer.ptr == '0' && n.lastmatch != last && (*n.lastmatch | 0x20) == 'x';
+        if (!n.valid || hex) {
+            // Infinities, NaNs and hexadecimal numbers are rare, and the locale has nothing to do with them
+            auto const size = static_cast<std::size_t>(last - number);
+            detail::c_text text (size);
+            *std::copy_n(number, size, text.data()) = '\0';
+            char * end;
+            auto const saved_errno = errno;
+            errno = 0;
+            auto const v = std::strtold(text.data(), &end);
+            auto const range_error = errno == ERANGE;
+            errno = saved_errno;
+            if (end == text.data())
+                return {first, std::errc::invalid_argument};
+            value = v;
+            return {number + (end - text.data()), range_error ? std::errc::result_out_of_range : std::errc()};
+        }
+
+        // Exact significand and power of ten: a single rounding makes the nearest long double
+        if (!n.too_many_digits && std::bit_width(n.mantissa) <= LDBL_MANT_DIG
+            && n.exponent >= -detail::exact_pow10_ld && n.exponent <= detail::exact_pow10_ld) {
+            auto v = static_cast<long double>(n.mantissa);
+            v = n.exponent < 0 ? v / detail::pow10_ld.v[-n.exponent] : v * detail::pow10_ld.v[n.exponent];
+            value = n.negative ? -v : v;
+            return {n.lastmatch, std::errc()};
+        }
+        return detail::strtold_c(n, first, value);
+    }
+#endif
+}
@@ -19,8 +19,14 @@
 #endif
 
 #include "external/has_member.hpp"
+#include "simd.hpp"
+#include "numbers.hpp"
 #include "external/ezgz/ezgz.hpp"
 #include "external/bz2_connector/bz2_connector.h"
+#ifndef ZSTD_STATIC_LINKING_ONLY
+    #define ZSTD_STATIC_LINKING_ONLY    // frame headers
+#endif
+#include "external/zstd/zstd.h"
 //-----------------------------
 
 #if (IS_CLANG==0)
@@ -50,13 +56,25 @@
 #include <functional>
 #include <filesystem>
 #include <algorithm>
+#include <array>
+#include <tuple>
 #include <concepts>
 #include <variant>
 #include <span>
 #include <cmath>
+#include <cstring>
 #include <utility>  // for std::exchange
 #include <cassert>
 #include <sstream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <new>
+#include <memory>
 
 define_has_member(span);
 
@@ -70,12 +88,22 @@ namespace csv_co {
         using cell_string::cell_string;
     };
 
+    /// Trim policy that narrows a view of the value, moving its bounds only: trimming takes no allocations
+    template<class T>
+    concept ViewTrimPolicyConcept = requires(std::string_view v) {
+        { T::trim(v) } -> std::convertible_to<std::string_view>;
+    };
+
+    /// Trim policy that returns trimmed copies of the strings (the original kind of policy)
     template<class T>
-    concept TrimPolicyConcept = requires(T, cell_string s, unquoted_cell_string u) {
+    concept StringTrimPolicyConcept = requires(T, cell_string s, unquoted_cell_string u) {
         { T::ret_trim(s) } -> std::convertible_to<cell_string>;
         { T::ret_trim(u) } -> std::convertible_to<unquoted_cell_string>;
     };
 
+    template<class T>
+    concept TrimPolicyConcept = ViewTrimPolicyConcept<T> || StringTrimPolicyConcept<T>;
+
     template<char ch>
     struct quote_char {
         constexpr static char value = ch;
@@ -151,6 +179,12 @@ namespace csv_co {
     namespace trim_policy {
         struct no_trimming {
         public:
+            /// Characters trimmed, lets cell_span trim in place without copying
+            constexpr static std::string_view trim_chars {};
+
+            constexpr static std::string_view trim(std::string_view v) noexcept {
+                return v;
+            }
             inline static cell_string ret_trim(cell_string const & cs) {
                 return cs;
             }
@@ -162,6 +196,15 @@ namespace csv_co {
         template<char const *list>
         struct trimming {
         public:
+            /// Characters trimmed, lets cell_span trim in place without copying
+            inline static std::string_view const trim_chars {list};
+
+            constexpr static std::string_view trim(std::string_view v) noexcept {
+                auto const first = v.find_first_not_of(list);
+                if (first == std::string_view::npos)
+                    return v.substr(v.size());
+                return v.substr(first, v.find_last_not_of(list) + 1 - first);
+            }
             inline static cell_string ret_trim(cell_string s) {
                 string_functions::trim_string<list>(s);
                 return s;
@@ -241,6 +284,44 @@ namespace csv_co {
         };
     }
 
+    template<class T>
+    concept ParseEnginePolicyConcept = requires {
+        { T::two_stage } -> std::convertible_to<bool>;
+        { T::coroutines } -> std::convertible_to<bool>;
+    };
+
+    /// Parse engine policies
+    namespace engine {
+        /// Byte-wise state machine, field contents are skipped by the vectorized scanner
+        struct state_machine {
+            constexpr static bool two_stage = false;
+            constexpr static bool coroutines = true;
+        };
+
+        /// Stage 1 indexes unquoted delimiters and line breaks of a chunk as a bitmap (quote parity is resolved
+        /// without branches), stage 2 feeds tracers at the set bits. Speed does not depend on quote density.
+        struct structural_index {
+            constexpr static bool two_stage = true;
+            constexpr static bool coroutines = true;
+        };
+
+        /// The structural_index engine run as a plain loop: the state between chunks is kept in an object, not in
+        /// a coroutine frame, so parsing allocates no frames and the compiler sees through every call.
+        /// The byte-wise state machine has no such variant, it suspends in the middle of quoted fields.
+        struct direct {
+            constexpr static bool two_stage = true;
+            constexpr static bool coroutines = false;
+        };
+    }
+
+#ifndef CSV_CO_DEFAULT_ENGINE
+    /// Engine of the readers that do not choose one, can be overridden at build time
+    #define CSV_CO_DEFAULT_ENGINE engine::structural_index
+#endif
+
+    /// Execution tag of the parallel validation: reader<>::validate<parallel>()
+    struct parallel {};
+
     constexpr bool trim_chars_do_not_conflict_with(auto ch, auto is_trimming_policy) {
         if (is_trimming_policy)
             return std::all_of(std::begin(trim_policy::chars), std::end(trim_policy::chars),[&](auto &elem) {
@@ -251,6 +332,9 @@ namespace csv_co {
     }
 
     using double_quotes = quote_char<'"'>;
+    /// Quote policy of CSV sources that never quote fields: quote characters are ordinary field contents,
+    /// parsers split at delimiters and line breaks only, conversions do not unquote
+    struct no_quotes : quote_char<'\0'> {};
     using comma_delimiter = delimiter<','>;
     using non_mac_ln_brk = line_break<'\n'>;
 
@@ -263,13 +347,629 @@ namespace csv_co {
     template<class T>
     struct empty_t {};
 
+    namespace detail {
+        /// Thread-local free lists of coroutine frames. A frame freed by a parse serves the next parse of the same
+        /// thread, so that parsing does not go to the heap in steady state. Frame sizes are rounded up to cache lines.
+        class frame_pool {
+            constexpr static std::size_t granularity = 64;
+            /// Frames of up to 4 KiB are pooled, larger ones go to the heap straight away
+            constexpr static std::size_t size_classes = 64;
+
+            struct free_frame {
+                free_frame * next;
+            };
+
+            struct free_lists {
+                free_frame * heads [size_classes] {};
+
+                ~free_lists() {
+                    for (auto head : heads)
+                        while (head)
+                            ::operator delete(std::exchange(head, head->next));
+                }
+            };
+
+            static free_lists & local() noexcept {
+                thread_local free_lists lists;
+                return lists;
+            }
+
+            static constexpr std::size_t size_class(std::size_t size) noexcept {
+                return (size + granularity - 1) / granularity;
+            }
+
+        public:
+            static void * allocate(std::size_t size) noexcept {
+                auto const c = size_class(size);
+                if (c >= size_classes)
+                    return ::operator new(size, std::nothrow);
+                if (auto & head = local().heads[c])
+                    return std::exchange(head, head->next);
+                return ::operator new(c * granularity, std::nothrow);
+            }
+
+            static void deallocate(void * frame, std::size_t size) noexcept {
+                auto const c = size_class(size);
+                if (c >= size_classes) {
+                    ::operator delete(frame);
+                    return;
+                }
+                auto & head = local().heads[c];
+                head = ::new (frame) free_frame {head};
+            }
+        };
+
+        /// Perfect hash of names to their positions (hash and displace): a name hashes to a bucket, the bucket's
+        /// displacement sends it to a slot that no other name takes. Lookups make one probe and one comparison.
+        class name_index {
+            std::vector<cell_string> names;
+            std::vector<std::uint32_t> positions;
+            std::vector<std::uint32_t> displacements;
+            std::uint64_t seed = 0;
+            std::uint64_t mask = 0;
+
+            static constexpr std::uint64_t mix(std::uint64_t h) noexcept {
+                h ^= h >> 31;
+                h *= 0x7fb5d329728ea185ull;
+                h ^= h >> 27;
+                h *= 0x81dadef4bc2dd44dull;
+                return h ^ (h >> 33);
+            }
+
+            std::uint64_t hash(std::string_view name) const noexcept {
+                auto h = seed ^ 0xcbf29ce484222325ull;
+                for (unsigned char c : name)
+                    h = (h ^ c) * 0x100000001b3ull;
+                return mix(h);
+            }
+
+            std::size_t bucket(std::uint64_t h) const noexcept {
+                return static_cast<std::size_t>((h >> 32) % displacements.size());
+            }
+
+            std::size_t slot(std::uint64_t h, std::uint32_t displacement) const noexcept {
+                return static_cast<std::size_t>((h ^ mix(displacement)) & mask);
+            }
+
+            /// Places names of the given positions with the current seed, false if some bucket finds no displacement
+            bool place(std::vector<cell_string> const & keys, std::vector<std::uint32_t> const & pos) {
+                std::vector<std::vector<std::uint32_t>> buckets (displacements.size());
+                std::vector<std::uint64_t> hashes (keys.size());
+                for (std::uint32_t i = 0; i != keys.size(); ++i)
+                    buckets[bucket(hashes[i] = hash(keys[i]))].push_back(i);
+
+                std::vector<std::uint32_t> order (buckets.size());
+                for (std::uint32_t b = 0; b != order.size(); ++b)
+                    order[b] = b;
+                // the largest buckets are placed while there is much room
+                std::stable_sort(order.begin(), order.end(), [&](auto l, auto r) { return buckets[l].size() > buckets[r].size(); });
+
+                std::fill(positions.begin(), positions.end(), npos);
+                std::vector<std::size_t> taken;
+                for (auto b : order) {
+                    if (buckets[b].empty())
+                        break;
+                    std::uint32_t d = 0;
+                    for (;; ++d) {
+                        if (d == (1u << 16))
+                            return false;
+                        taken.clear();
+                        auto fits = true;
+                        for (auto i : buckets[b]) {
+                            auto const sl = slot(hashes[i], d);
+                            if (positions[sl] != npos || std::find(taken.begin(), taken.end(), sl) != taken.end()) {
+                                fits = false;
+                                break;
+                            }
+                            taken.push_back(sl);
+                        }
+                        if (fits)
+                            break;
+                    }
+                    displacements[b] = d;
+                    for (auto n = 0u; n != buckets[b].size(); ++n) {
+                        names[taken[n]] = keys[buckets[b][n]];
+                        positions[taken[n]] = pos[buckets[b][n]];
+                    }
+                }
+                return true;
+            }
+
+        public:
+            constexpr static std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+            /// Indexes names[i] -> i. Of equal names, the last one counts.
+            void assign(std::vector<cell_string> const & in_order) {
+                std::vector<std::uint32_t> order (in_order.size());
+                for (std::uint32_t i = 0; i != order.size(); ++i)
+                    order[i] = i;
+                std::stable_sort(order.begin(), order.end(), [&](auto l, auto r) { return in_order[l] < in_order[r]; });
+                std::vector<cell_string> keys;
+                std::vector<std::uint32_t> pos;
+                for (auto i : order) {
+                    if (!keys.empty() && keys.back() == in_order[i])
+                        pos.back() = i;
+                    else {
+                        keys.push_back(in_order[i]);
+                        pos.push_back(i);
+                    }
+                }
+
+                auto slots = std::bit_ceil(keys.size() + keys.size() / 4 + 1);
+                displacements.assign(keys.size() / 4 + 1, 0);
+                for (seed = 0;; ++seed) {
+                    names.assign(slots, cell_string{});
+                    positions.assign(slots, npos);
+                    mask = slots - 1;
+                    if (place(keys, pos))
+                        break;
+                    // a few unlucky seeds in a row: more room
+                    if (seed % 8 == 7)
+                        slots *= 2;
+                }
+            }
+
+            [[nodiscard]] bool empty() const noexcept {
+                return names.empty();
+            }
+
+            /// Position of a name, or npos
+            [[nodiscard]] std::uint32_t find(std::string_view name) const noexcept {
+                if (names.empty())
+                    return npos;
+                auto const h = hash(name);
+                auto const sl = slot(h, displacements[bucket(h)]);
+                return names[sl] == name ? positions[sl] : npos;
+            }
+        };
+
+        /// Thread-local storage of the structural index of a data chunk. The index is built and consumed within one
+        /// chunk of one parser, so the parsers of a thread can share it however their chunks interleave.
+        inline std::vector<std::uint64_t> & chunk_index() noexcept {
+            thread_local std::vector<std::uint64_t> index;
+            return index;
+        }
+
+        /// Decompressed CSV handed out batch by batch, so that an archive is never inflated as a whole
+        class byte_stream {
+        public:
+            virtual ~byte_stream() = default;
+            /// Next batch of bytes, valid until the next call. Empty at the end of the stream.
+            virtual std::span<char const> next() = 0;
+            /// Starts over from the beginning of the stream
+            virtual void rewind() = 0;
+        };
+
+        /// .gz archive inflated by EzGz as it is read
+        class gz_stream final : public byte_stream {
+            std::string path;
+            std::optional<EzGz::IGzFile<>> file;
+        public:
+            explicit gz_stream(std::string path) : path(std::move(path)) {
+                rewind();
+            }
+            std::span<char const> next() override {
+                while (auto const batch = file->readSome())
+                    if (!batch->empty())
+                        return *batch;
+                return {};
+            }
+            void rewind() override {
+                file.reset();
+                file.emplace(path);
+            }
+        };
+
+        /// .bz2 archive decompressed by bz2_connector as it is read
+        class bz2_stream final : public byte_stream {
+            bz2_connector::stream_reader file;
+        public:
+            explicit bz2_stream(std::string const & path) : file(path.c_str()) {}
+            std::span<char const> next() override {
+                return file.read();
+            }
+            void rewind() override {
+                file.rewind();
+            }
+        };
+
+        /// .zst archive decompressed by zstd as it is read, a frame after another. Memory is bounded by the window of a
+        /// frame and two buffers of the sizes zstd recommends.
+        class zst_stream final : public byte_stream {
+            std::ifstream file;
+            std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context {ZSTD_createDCtx(), &ZSTD_freeDCtx};
+            std::vector<char> in = std::vector<char>(ZSTD_DStreamInSize());
+            std::vector<char> out = std::vector<char>(ZSTD_DStreamOutSize());
+            ZSTD_inBuffer input {in.data(), 0, 0};
+            std::size_t hint = 0;   // not 0 within a frame
+            bool full = false;      // the last output filled the buffer, more of it may be held by zstd
+        public:
+            explicit zst_stream(std::string const & path) : file(path, std::ios::binary) {
+                if (!file)
+                    throw std::runtime_error("zstd: no file found: " + path);
+                if (!context)
+                    throw std::bad_alloc();
+            }
+            std::span<char const> next() override {
+                for (;;) {
+                    if (input.pos == input.size && !full) {
+                        file.read(in.data(), static_cast<std::streamsize>(in.size()));
+                        input.size = static_cast<std::size_t>(file.gcount());
+                        input.pos = 0;
+                        if (!input.size) {
+                            if (hint)
+                                throw std::runtime_error("zstd: truncated frame");
+                            return {};
+                        }
+                    }
+                    ZSTD_outBuffer output {out.data(), out.size(), 0};
+                    hint = ZSTD_decompressStream(context.get(), &output, &input);
+                    if (ZSTD_isError(hint))
+                        throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(hint));
+                    full = output.pos == output.size;
+                    if (output.pos)
+                        return {out.data(), output.pos};
+                }
+            }
+            void rewind() override {
+                file.clear();
+                file.seekg(0);
+                ZSTD_DCtx_reset(context.get(), ZSTD_reset_session_only);
+                input = {in.data(), 0, 0};
+                hint = 0;
+                full = false;
+            }
+        };
+
+        /// A frame of a .zst file
+        struct zst_frame {
+            std::uint64_t offset;       // in the file
+            std::uint64_t size;         // compressed
+            std::uint64_t content;      // decompressed, ZSTD_CONTENTSIZE_UNKNOWN if not told
+        };
+
+        /// The frames of a .zst file, skippable ones left out: from the seek table of the seekable format if there is
+        /// one, otherwise from the headers of the frames and of their blocks, nothing being decompressed. Empty if the
+        /// file is none of these (legacy frames, say).
+        inline std::vector<zst_frame> zst_frames(std::ifstream & file) {
+            auto const read_at = [&](std::uint64_t at, void * to, std::size_t n) {
+                file.clear();
+                file.seekg(static_cast<std::streamoff>(at));
+                file.read(static_cast<char *>(to), static_cast<std::streamsize>(n));
+                return static_cast<std::size_t>(file.gcount());
+            };
+            auto const le32 = [](unsigned char const * p) {
+                return std::uint32_t(p[0]) | std::uint32_t(p[1]) << 8 | std::uint32_t(p[2]) << 16 | std::uint32_t(p[3]) << 24;
+            };
+
+            file.clear();
+            file.seekg(0, std::ios::end);
+            auto const file_size = static_cast<std::uint64_t>(file.tellg());
+            std::vector<zst_frame> frames;
+
+            // Seekable format: the last, skippable, frame lists the sizes of the frames and ends with a footer
+            constexpr std::uint32_t seek_table_magic = 0x184D2A5E;
+            constexpr std::uint32_t seekable_magic = 0x8F92EAB1;
+            unsigned char footer[9];
+            if (file_size >= ZSTD_SKIPPABLEHEADERSIZE + sizeof footer && read_at(file_size - sizeof footer, footer, sizeof footer) == sizeof footer
+                && le32(footer + 5) == seekable_magic) {
+                auto const entry = footer[4] & 0x80 ? 12u : 8u;
+                auto const table = ZSTD_SKIPPABLEHEADERSIZE + std::uint64_t(le32(footer)) * entry + sizeof footer;
+                std::vector<unsigned char> t (table <= file_size ? table : 0);
+                if (!t.empty() && read_at(file_size - table, t.data(), table) == table
+                    && le32(t.data()) == seek_table_magic && le32(t.data() + 4) == table - ZSTD_SKIPPABLEHEADERSIZE) {
+                    std::uint64_t offset = 0;
+                    for (auto e = t.data() + ZSTD_SKIPPABLEHEADERSIZE; e != t.data() + table - sizeof footer; e += entry) {
+                        if (le32(e))
+                            frames.push_back({offset, le32(e), le32(e + 4)});
+                        offset += le32(e);
+                    }
+                    if (offset == file_size - table)
+                        return frames;
+                    frames.clear();
+                }
+            }
+
+            for (std::uint64_t offset = 0; offset < file_size;) {
+                unsigned char header[ZSTD_FRAMEHEADERSIZE_MAX];
+                ZSTD_frameHeader h;
+                if (ZSTD_getFrameHeader(&h, header, read_at(offset, header, sizeof header)) != 0)
+                    return {};
+                if (h.frameType == ZSTD_skippableFrame) {
+                    offset += ZSTD_SKIPPABLEHEADERSIZE + h.frameContentSize;
+                    continue;
+                }
+                auto at = offset + h.headerSize;
+                for (bool last = false; !last;) {
+                    unsigned char b[3];
+                    if (read_at(at, b, sizeof b) != sizeof b)
+                        return {};
+                    auto const block = std::uint32_t(b[0]) | std::uint32_t(b[1]) << 8 | std::uint32_t(b[2]) << 16;
+                    last = block & 1;
+                    // an RLE block holds a single byte
+                    at += sizeof b + (((block >> 1) & 3) == 1 ? 1 : block >> 3);
+                }
+                at += h.checksumFlag ? 4 : 0;
+                frames.push_back({offset, at - offset, h.frameContentSize});
+                offset = at;
+            }
+            return frames;
+        }
+
+        /// .zst archive of several frames, decompressed by threads a few frames ahead and handed out in order, a frame
+        /// at a time. Frames are independent of each other, so it can also start at any of them. A frame is decompressed
+        /// whole, into a buffer of the size its header tells: memory is bounded for frames of at most max_frame bytes.
+        class zst_frames_stream final : public byte_stream {
+            struct job {
+                zst_frame frame;
+                std::vector<char> in;
+                std::vector<char> out;
+                std::string error;
+                bool done = false;
+            };
+
+            std::ifstream file;
+            std::vector<zst_frame> frames;
+            std::size_t next_frame = 0;                 // to be read from the file
+            std::size_t depth;                          // frames decompressed ahead of the one handed out
+            std::deque<std::unique_ptr<job>> jobs;      // in the order of the file
+            std::deque<job *> pending;                  // yet to be decompressed
+            std::unique_ptr<job> current;               // handed out
+            std::vector<std::unique_ptr<job>> spare;    // jobs whose buffers are to be used again
+            std::mutex m;
+            std::condition_variable work;
+            std::condition_variable done;
+            bool stopping = false;
+            std::vector<std::thread> workers;
+
+            static void decompress(ZSTD_DCtx * context, job & j) {
+                ZSTD_DCtx_reset(context, ZSTD_reset_session_only);
+                if (j.frame.content > max_frame)
+                    throw std::runtime_error("zstd: frame too large to decompress whole");
+                // a byte more than told, to find frames larger than their headers tell
+                j.out.resize(j.frame.content + 1);
+                ZSTD_inBuffer input {j.in.data(), j.in.size(), 0};
+                ZSTD_outBuffer output {j.out.data(), j.out.size(), 0};
+                for (;;) {
+                    auto const hint = ZSTD_decompressStream(context, &output, &input);
+                    if (ZSTD_isError(hint))
+                        throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(hint));
+                    if (output.pos == output.size)
+                        throw std::runtime_error("zstd: frame larger than its header tells");
+                    if (!hint)
+                        break;
+                    if (input.pos == input.size)
+                        throw std::runtime_error("zstd: truncated frame");
+                }
+                j.out.resize(output.pos);
+            }
+
+            void decompress_frames() {
+                std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context {ZSTD_createDCtx(), &ZSTD_freeDCtx};
+                for (;;) {
+                    job * j;
+                    {
+                        std::unique_lock lock (m);
+                        work.wait(lock, [&] { return stopping || !pending.empty(); });
+                        if (stopping)
+                            return;
+                        j = pending.front();
+                        pending.pop_front();
+                    }
+                    std::string error;
+                    try {
+                        if (!context)
+                            throw std::bad_alloc();
+                        decompress(context.get(), *j);
+                    } catch (std::exception const & e) {
+                        error = e.what();
+                    }
+                    {
+                        std::lock_guard lock (m);
+                        j->error = std::move(error);
+                        j->done = true;
+                    }
+                    done.notify_all();
+                }
+            }
+
+            void wait(job const & j) {
+                std::unique_lock lock (m);
+                done.wait(lock, [&] { return j.done; });
+            }
+
+            /// Waits for the frames in work and keeps their jobs for later ones
+            void drop_jobs() {
+                for (auto & j : jobs) {
+                    wait(*j);
+                    spare.push_back(std::move(j));
+                }
+                jobs.clear();
+                if (current)
+                    spare.push_back(std::move(current));
+            }
+
+            void stop() noexcept {
+                {
+                    std::lock_guard lock (m);
+                    stopping = true;
+                }
+                work.notify_all();
+                for (auto & w : workers)
+                    w.join();
+                workers.clear();
+            }
+
+        public:
+            /// Largest decompressed size of a frame, as seekable archives are cut into
+            constexpr static std::uint64_t max_frame = 4 << 20;
+
+            /// Whether frames can be decompressed whole: all of them of known sizes not over max_frame
+            static bool bounded(std::vector<zst_frame> const & frames) noexcept {
+                return std::all_of(frames.begin(), frames.end(), [](zst_frame const & f) {
+                    return f.content <= max_frame && f.size <= ZSTD_COMPRESSBOUND(max_frame);
+                });
+            }
+
+            zst_frames_stream(std::string const & path, std::vector<zst_frame> frames, unsigned threads)
+                : file(path, std::ios::binary), frames(std::move(frames)), depth(2 * std::max(1u, threads)) {
+                if (!file)
+                    throw std::runtime_error("zstd: no file found: " + path);
+                try {
+                    for (auto i = 0u; i != std::max(1u, threads); ++i)
+                        workers.emplace_back([this] { decompress_frames(); });
+                } catch (...) {
+                    stop();
+                    throw;
+                }
+            }
+
+            ~zst_frames_stream() override {
+                stop();
+            }
+
+            std::span<char const> next() override {
+                if (current)
+                    spare.push_back(std::move(current));
+                while (jobs.size() < depth && next_frame != frames.size()) {
+                    std::unique_ptr<job> j;
+                    if (!spare.empty()) {
+                        j = std::move(spare.back());
+                        spare.pop_back();
+                    } else
+                        j = std::make_unique<job>();
+                    j->frame = frames[next_frame++];
+                    j->done = false;
+                    j->in.resize(j->frame.size);
+                    file.clear();
+                    file.seekg(static_cast<std::streamoff>(j->frame.offset));
+                    if (!file.read(j->in.data(), static_cast<std::streamsize>(j->in.size())))
+                        throw std::runtime_error("zstd: truncated frame");
+                    {
+                        std::lock_guard lock (m);
+                        pending.push_back(j.get());
+                    }
+                    jobs.push_back(std::move(j));
+                    work.notify_one();
+                }
+                while (!jobs.empty()) {
+                    current = std::move(jobs.front());
+                    jobs.pop_front();
+                    wait(*current);
+                    if (!current->error.empty())
+                        throw std::runtime_error(current->error);
+                    if (!current->out.empty())
+                        return current->out;
+                    spare.push_back(std::move(current));
+                }
+                return {};
+            }
+
+            void rewind() override {
+                drop_jobs();
+                next_frame = 0;
+            }
+
+            /// Goes to the frame holding the given byte of the decompressed data, returns the offset that frame starts
+            /// at (the size of the data if the byte is beyond). The sizes of the frames before it must be known.
+            /// Internal only, reader<> does not open archives at an offset: a frame may start within a quoted field,
+            /// and a row boundary cannot be told there without the data before it.
+            std::uint64_t seek(std::uint64_t offset) {
+                drop_jobs();
+                std::uint64_t start = 0;
+                for (next_frame = 0; next_frame != frames.size(); start += frames[next_frame++].content) {
+                    if (frames[next_frame].content == ZSTD_CONTENTSIZE_UNKNOWN)
+                        throw std::runtime_error("zstd: unknown size of a frame");
+                    if (offset < start + frames[next_frame].content)
+                        break;
+                }
+                return start;
+            }
+        };
+
+        /// Stream of a .zst file: its frames decompressed by threads if there are several of them, all small enough to
+        /// be decompressed whole, and several threads to run; streamed one after another otherwise
+        inline std::unique_ptr<byte_stream> zst_source(std::string const & path) {
+            if (auto const threads = std::thread::hardware_concurrency(); threads > 1) {
+                std::ifstream file (path, std::ios::binary);
+                if (auto frames = file ? zst_frames(file) : std::vector<zst_frame> {};
+                    frames.size() > 1 && zst_frames_stream::bounded(frames))
+                    return std::make_unique<zst_frames_stream>(path, std::move(frames), threads);
+            }
+            return std::make_unique<zst_stream>(path);
+        }
+
+        /// Cuts a byte stream into windows of whole rows of at least a given size (larger if a row is): a window ends
+        /// with the first line break outside of quotes in the batch that fills it up. The rest of that batch, the
+        /// beginning of the next row, is carried over to the next window.
+        template <char Quote, char LineBreak, bool Quoting>
+        class row_windows {
+            std::unique_ptr<byte_stream> stream;
+            std::vector<char> carry;
+            std::size_t size;
+            std::size_t got = 0;    // windows handed out since the start of the stream
+        public:
+            row_windows(std::unique_ptr<byte_stream> stream, std::size_t size) : stream(std::move(stream)), size(size) {}
+
+            /// Number of the window got, 0 for the first one of the stream
+            [[nodiscard]] std::size_t index() const noexcept { return got - 1; }
+
+            /// Replaces the window by the next one, false (and the window intact) at the end of the stream
+            bool next(std::vector<char> & window) {
+                auto & w = carry;
+                auto constexpr npos = std::string_view::npos;
+                // the carried bytes begin a row, so they begin outside of quotes
+                std::size_t boundary = npos;
+                bool in_quotes = false;
+                auto const scan = [&](std::size_t from) noexcept {
+                    auto const s = simd::summarize<Quote, LineBreak, Quoting>(w.data() + from, w.data() + w.size());
+                    if (auto const lf = s.first_break[in_quotes])
+                        boundary = static_cast<std::size_t>(lf - w.data());
+                    in_quotes ^= s.odd_quotes;
+                };
+                if (!w.empty())
+                    scan(0);
+                bool more = true;
+                while (w.size() < size || boundary == npos) {
+                    auto const batch = stream->next();
+                    if (batch.empty()) {
+                        more = false;
+                        break;
+                    }
+                    auto const from = w.size();
+                    w.insert(w.end(), batch.begin(), batch.end());
+                    scan(from);
+                }
+                if (w.empty())
+                    return false;
+                ++got;
+                window.swap(w);
+                w.clear();
+                if (more && boundary + 1 < window.size()) {
+                    w.assign(window.begin() + static_cast<std::ptrdiff_t>(boundary + 1), window.end());
+                    window.resize(boundary + 1);
+                }
+                return true;
+            }
+
+            /// Starts over: the next window is the first one again
+            void rewind(std::vector<char> & window) {
+                stream->rewind();
+                carry.clear();
+                got = 0;
+                next(window);
+            }
+        };
+    }
+
     /// CSV reader class
-    template<TrimPolicyConcept TrimPolicy = trim_policy::no_trimming, QuoteConcept Quote = double_quotes, DelimiterConcept Delimiter = comma_delimiter, LineBreakConcept LineBreak = non_mac_ln_brk, MaxFieldSizePolicyConcept MaxFieldSize = MFS::no_trace, EmptyRowsPolicyConcept EmptyRows = ER::std_4180>
+    template<TrimPolicyConcept TrimPolicy = trim_policy::no_trimming, QuoteConcept Quote = double_quotes, DelimiterConcept Delimiter = comma_delimiter, LineBreakConcept LineBreak = non_mac_ln_brk, MaxFieldSizePolicyConcept MaxFieldSize = MFS::no_trace, EmptyRowsPolicyConcept EmptyRows = ER::std_4180, ParseEnginePolicyConcept Engine = CSV_CO_DEFAULT_ENGINE>
     class reader final : public std::conditional_t<!std::is_same_v<MaxFieldSize, MFS::no_trace>, MaxFieldSize, empty_t<void>>, protected std::conditional_t<!std::is_same_v<EmptyRows, ER::std_4180>, EmptyRows, empty_t<int>> {
 
         constexpr static std::size_t default_chunk_size = 1024 * 50;
         constexpr static bool max_field_size_no_trace = std::is_same_v<MaxFieldSize, MFS::no_trace>;
         constexpr static bool empty_rows_ignore = std::is_same_v<EmptyRows, ER::ignore>;
+        constexpr static bool quoting = !std::is_same_v<Quote, no_quotes>;
 
     public:
         /// User notification callback reason
@@ -278,6 +978,12 @@ namespace csv_co {
             empty_rows_reason
         };
 
+        /// Delivery order of the parallel iteration modes
+        enum class delivery {
+            unordered = 0,
+            ordered
+        };
+
     private:
         /// User notification callback type
         using notification_cb_t = std::function<void(notification_reason)>;
@@ -293,6 +999,11 @@ namespace csv_co {
 
             G get_return_object() { return G{this}; };
 
+            /// Frames come from the thread-local pool
+            static void * operator new(std::size_t size) noexcept { return detail::frame_pool::allocate(size); }
+
+            static void operator delete(void * frame, std::size_t size) noexcept { detail::frame_pool::deallocate(frame, size); }
+
             std::suspend_always initial_suspend() { return {}; }
 
             std::suspend_always final_suspend() noexcept { return {}; }
@@ -434,23 +1145,55 @@ namespace csv_co {
         class cell_span;
 
     private:
-        /// Header's field callback type of the span iteration mode
-        using header_field_span_cb_t = std::function<void(cell_span &span)>;
-        /// Value's field callback type of the span iteration mode 
-        using value_field_span_cb_t = std::function<void(cell_span &span)>;
-        /// New row callback type
-        using new_row_cb_t = std::function<void()>;
+        /// Header's or value's field callback of the span iteration mode: any callable taking cell_span &
+        template <typename F>
+        constexpr static bool field_span_callback = std::invocable<F &, cell_span &>;
+        /// New row callback: any callable taking nothing
+        template <typename F>
+        constexpr static bool new_row_callback = std::invocable<F &>;
 
     public:
         /// Row span class forward declaration
         struct row_span;
     private:
-        /// Header row callback type
-        using header_row_span_cb_t = std::function<void(row_span &span)>;
-        /// Value row callback type   
-        using value_row_span_cb_t = std::function<void(row_span &span)>;
+        /// Header row or value row callback of the row iteration mode: any callable taking row_span &
+        template <typename F>
+        constexpr static bool row_span_callback = std::invocable<F &, row_span &>;
+
+        /// Callback doing nothing, in place of the ones not given
+        struct no_callback {
+            constexpr void operator()(auto && ...) const noexcept {}
+        };
 
     public:
+        /// Column found by name once (see column()), indexes rows as fast as a number does
+        struct column_handle {
+            std::size_t index;
+        };
+
+        /// Result of a cast that doesn't throw: the value, or T{} and the reason it failed
+        template <typename T>
+        struct cast_result {
+            T value {};
+            std::errc ec {};
+
+            explicit operator bool() const noexcept { return ec == std::errc(); }
+            T const & operator*() const noexcept { return value; }
+        };
+
+        /// Column cast in bulk: values of the rows, T{} where a cell failed to cast, marked in a bitmask
+        template <typename T>
+        struct column_cast {
+            std::vector<T> values;
+            /// Bit (row % 64) of word (row / 64) is set if the cell of the row failed to cast
+            std::vector<std::uint64_t> failures;
+            std::size_t failed = 0;
+
+            [[nodiscard]] bool failed_at(std::size_t row) const noexcept {
+                return (failures[row / 64] >> (row % 64)) & 1;
+            }
+        };
+
         /// Row span class definition
         struct row_span : protected std::span<cell_span> {
 
@@ -461,21 +1204,32 @@ namespace csv_co {
             using std::span<cell_span>::size;
 
             template<typename It>
-            row_span(It first, size_t c) noexcept(noexcept(std::span<cell_span>(first, c))) : 
-                std::span<cell_span>(first, c) {}
+            row_span(It first, size_t c, detail::name_index const * header = nullptr) noexcept(noexcept(std::span<cell_span>(first, c))) :
+                std::span<cell_span>(first, c), header(header) {}
 
             /// Element access operator (by index).
             /// To be fast UB is allowed (cross-boundary access), should be noexcept.
             using std::span<cell_span>::operator[];
 
-            /// Element access operator (by name).
+            /// Element access operator (by column handle), as fast as the one by index.
             /// To be fast UB is allowed (cross-boundary access), should be noexcept.
-            cell_span const &operator[](cell_string const & cs) const noexcept {
-                auto const search = reader::col_name_2_index_map.find(cs);
-                assert(search != reader::col_name_2_index_map.end());
-                return std::span<cell_span>::operator[](search->second);
+            cell_span const &operator[](column_handle c) const noexcept {
+                return std::span<cell_span>::operator[](c.index);
             }
 
+            /// Element access operator (by name), a perfect hash lookup in the header of the reader.
+            /// To be fast UB is allowed (cross-boundary access), should be noexcept.
+            cell_span const &operator[](std::string_view name) const noexcept {
+                assert(header);
+                auto const index = header->find(name);
+                assert(index != detail::name_index::npos);
+                return std::span<cell_span>::operator[](index);
+            }
+
+        private:
+            detail::name_index const * header;
+        public:
+
             friend std::ostream &operator<<(std::ostream &os, row_span const &rs) {
                 for (auto const &elem: rs)
                     os << elem.operator cell_string() << " ";
@@ -495,13 +1249,180 @@ namespace csv_co {
                 using namespace string_functions;
                 // A mangled result string
                 auto s = unquoted_cell_string{b, e};
-                // If the field was (completely) quoted -> it must be unquoted
-                unquote(s, Quote::value);
-                // Fields partly quoted and not-quoted at all: must be spared from double quoting
-                unique_quote(s, Quote::value);
+                // Nothing to unquote in fields without quotes
+                if constexpr (quoting) {
+                    if (b != e && std::memchr(b, Quote::value, e - b)) {
+                        // If the field was (completely) quoted -> it must be unquoted
+                        unquote(s, Quote::value);
+                        // Fields partly quoted and not-quoted at all: must be spared from double quoting
+                        unique_quote(s, Quote::value);
+                    }
+                }
                 return s;
             }
 
+            /// Where the unquoted and trimmed value lies within the raw bytes
+            struct shape {
+                constexpr static auto npos = std::string_view::npos;
+                /// Bounds of the value once trimmed
+                std::size_t lo = 0, hi = 0;
+                /// Enclosing quotes that unquoting drops, npos if none
+                std::size_t open = npos, close = npos;
+                /// The value is the contiguous slice [lo, hi) of the raw bytes
+                bool plain = true;
+                /// False if the value can't be located in place (a custom trim policy, an unpaired quote)
+                bool known = true;
+            };
+
+            /// Applies the trim policy to a string of either kind, in place if the policy trims views
+            template<typename S>
+            static S trimmed(S s) {
+                if constexpr (ViewTrimPolicyConcept<TrimPolicy>) {
+                    std::string_view const v = TrimPolicy::trim(std::string_view{s});
+                    if (v.empty())
+                        s.clear();
+                    else {
+                        auto const lo = static_cast<std::size_t>(v.data() - s.data());
+                        s.erase(lo + v.size());
+                        s.erase(0, lo);
+                    }
+                    return s;
+                } else
+                    return TrimPolicy::ret_trim(std::move(s));
+            }
+
+            /// Makes the same decisions as string() followed by the trim policy, on the raw bytes
+            [[nodiscard]] shape layout() const noexcept {
+                auto const s = raw_string_view();
+                shape r {.hi = s.size()};
+                constexpr bool by_chars = requires { TrimPolicy::trim_chars; };
+                if constexpr (!by_chars && !ViewTrimPolicyConcept<TrimPolicy>) {
+                    r.known = false;
+                    return r;
+                } else {
+                    bool quoted = false;
+                    if constexpr (quoting) {
+                        if constexpr (by_chars) {
+                            if (std::string_view{TrimPolicy::trim_chars}.find(Quote::value) != shape::npos) {
+                                r.known = false;
+                                return r;
+                            }
+                        }
+                        quoted = !s.empty() && std::memchr(s.data(), Quote::value, s.size());
+                        if (quoted) {
+                            // See unquote(): the quote opening the field and the last one, if only spaces follow it
+                            auto const d = s.find_first_not_of(" \n\r\t");
+                            if (s[d] == Quote::value) {
+                                auto const p = s.find_last_of(Quote::value);
+                                if (s.find_first_not_of(" \n\r\t", p + 1) == shape::npos) {
+                                    if (p == d) {
+                                        r.known = false;
+                                        return r;
+                                    }
+                                    r.open = d;
+                                    r.close = p;
+                                }
+                            }
+                        }
+                    }
+                    if constexpr (by_chars) {
+                        std::string_view const trim_chars = TrimPolicy::trim_chars;
+                        auto const dropped = [&r](std::size_t i) noexcept { return i == r.open || i == r.close; };
+                        while (r.lo < r.hi && (dropped(r.lo) || trim_chars.find(s[r.lo]) != shape::npos))
+                            ++r.lo;
+                        while (r.hi > r.lo && (dropped(r.hi - 1) || trim_chars.find(s[r.hi - 1]) != shape::npos))
+                            --r.hi;
+                        if (quoted)
+                            for (auto k = r.lo; k < r.hi && r.plain; ++k)
+                                r.plain = kept(r, k);
+                    } else {
+                        // Only a contiguous value can be handed to the policy: quotes just around it, no runs to collapse
+                        if (r.open != shape::npos) {
+                            if (r.open != 0 || r.close != s.size() - 1) {
+                                r.known = false;
+                                return r;
+                            }
+                            r.lo = 1;
+                            r.hi = s.size() - 1;
+                        }
+                        if (quoted)
+                            for (auto k = r.lo; k < r.hi; ++k)
+                                if (!kept(r, k)) {
+                                    r.known = false;
+                                    return r;
+                                }
+                        std::string_view const v = TrimPolicy::trim(s.substr(r.lo, r.hi - r.lo));
+                        if (v.empty())
+                            r.hi = r.lo;
+                        else {
+                            r.lo = static_cast<std::size_t>(v.data() - s.data());
+                            r.hi = r.lo + v.size();
+                        }
+                    }
+                    return r;
+                }
+            }
+
+            /// Whether the raw byte k survives unquoting and collapsing of quote runs (see unique_quote())
+            [[nodiscard]] bool kept(shape const &r, std::size_t k) const noexcept {
+                if (k == r.open || k == r.close)
+                    return false;
+                return !(b[k] == Quote::value && k > 0 && b[k - 1] == Quote::value && k - 1 != r.open);
+            }
+
+            /// Parses an unquoted and trimmed value as a number of T, reporting errors by code
+            template<typename T>
+            static cast_result<T> try_number(std::string_view value) noexcept {
+                auto const first_not_backspace = value.find_first_not_of(' ');
+                if (first_not_backspace == std::string::npos)
+                    return {T{}, std::errc::invalid_argument};
+                auto const value_data_offset = value.data() + first_not_backspace;
+                auto const value_data_end = value.data() + value.size();
+
+                cast_result<T> r;
+                if constexpr (!std::is_same_v<T, long double>) {
+                    if constexpr (std::is_integral_v<T>)
+                        r.ec = numbers::parse_integer(value_data_offset, value_data_end, r.value).ec;
+                    else { // float and double
+#ifdef _MSC_VER
+                        r.ec = std::from_chars(value_data_offset, value_data_end, r.value, std::chars_format::general).ec;
+#else
+                        r.ec = fast_float::from_chars(value_data_offset, value_data_end, r.value).ec;
+#endif
+                    }
+                } else { // long double
+#ifdef _MSC_VER
+                    r.ec = std::from_chars(value_data_offset, value_data_end, r.value, std::chars_format::general).ec;
+#else
+                    // long doubles are not supported in either std or fast_float libraries' from_chars() functions
+                    r.ec = numbers::parse_long_double(value.data(), value_data_end, r.value).ec;
+#endif
+                }
+                if (r.ec != std::errc())
+                    r.value = T{};
+                return r;
+            }
+
+            /// Parses an unquoted and trimmed value as a number of T, throwing on errors
+            template<typename T>
+            static T number(std::string_view value) {
+                auto const r = try_number<T>(value);
+                if (r)
+                    return r.value;
+                else if (value.find_first_not_of(' ') == std::string::npos)
+                    throw reader::exception("Argument is empty");
+                else if (r.ec == std::errc::invalid_argument)
+                    throw reader::exception("Argument isn't a number: ", value);
+#ifndef _MSC_VER
+                else if (std::is_same_v<T, long double> && r.ec == std::errc::result_out_of_range)
+                    throw reader::exception("Range error, got inf: ", value);
+#endif
+                else if (r.ec == std::errc::result_out_of_range)
+                    throw reader::exception("This number ", value, " is larger than ", type_name<T>());
+                else
+                    throw reader::exception("Unknown error with ", value);
+            }
+
         public:
             using reader_type = reader;
 
@@ -529,14 +1450,42 @@ namespace csv_co {
             /* implicit conversion operator */
             /// Conversion to unquoted string
             operator unquoted_cell_string() const {
-                return TrimPolicy::ret_trim(string());
+                auto const r = layout();
+                if (!r.known)
+                    return trimmed(string());
+                if (r.plain)
+                    return {b + r.lo, b + r.hi};
+                unquoted_cell_string s;
+                s.reserve(r.hi - r.lo);
+                for (auto k = r.lo; k < r.hi; ++k)
+                    if (kept(r, k))
+                        s.push_back(b[k]);
+                return s;
             };
 
+            /// Unquoted and trimmed value as a view into the source, if it is there as is.
+            /// Nothing if quotes inside must be collapsed: convert to unquoted_cell_string then.
+            [[nodiscard]] std::optional<std::string_view> unquoted_view() const noexcept {
+                auto const r = layout();
+                if (r.known && r.plain)
+                    return std::string_view{b + r.lo, r.hi - r.lo};
+                return std::nullopt;
+            }
+
             /// Conversion to unchanged cell string except for applying trimming strategy
             operator cell_string() const {
-                return TrimPolicy::ret_trim(raw_string());
+                if constexpr (ViewTrimPolicyConcept<TrimPolicy>) {
+                    auto const v = trimmed_view();
+                    return {v.begin(), v.end()};
+                } else
+                    return TrimPolicy::ret_trim(raw_string());
             };
 
+            /// Unchanged cell string view except for applying trimming strategy, without copying
+            [[nodiscard]] std::string_view trimmed_view() const noexcept requires ViewTrimPolicyConcept<TrimPolicy> {
+                return TrimPolicy::trim(raw_string_view());
+            }
+
             /// Function that returns the completely unchanged cell string
             [[nodiscard]] cell_string raw_string() const {
                 return {b, e};
@@ -550,69 +1499,37 @@ namespace csv_co {
             /// Conversion operator to any arithmetic type
             template<typename T>
             T as() const requires std::is_arithmetic_v<T> {
-                auto const value = operator unquoted_cell_string();
-                auto const first_not_backspace = value.find_first_not_of(' ');
-                if (value.empty() or first_not_backspace == std::string::npos)
-                    throw reader::exception("Argument is empty");
-                else {
-                    auto process_result = [&](auto && r, auto const & v) {
-                        if (r.ec == std::errc())
-                            return v;
-                        else if (r.ec == std::errc::invalid_argument)
-                            throw reader::exception("Argument isn't a number: ", value);
-                        else if (r.ec == std::errc::result_out_of_range)
-                            throw reader::exception("This number ", value, " is larger than ", type_name<std::decay_t<decltype(v)>>());
-                        else
-                            throw reader::exception("Unknown error with ", value);
-                    };
-
-                    assert(first_not_backspace != std::string::npos);
-                    auto const value_data_offset = value.data() + first_not_backspace;
-                    auto const value_data_end = value.data() + value.size();
-
-                    if constexpr (!std::is_same_v<T, long double>) {
-                        T v;
-                        if constexpr (std::is_integral_v<T>) {
-                            auto int_r = std::from_chars(value_data_offset, value_data_end, v);
-                            return process_result(std::forward<std::from_chars_result>(int_r), v);
-                        }
-                        else { // float and double
-#ifdef _MSC_VER
-                            std::from_chars_result r;
-                            r = std::from_chars(value_data_offset, value_data_end, v, std::chars_format::general);
-                            return process_result(std::forward<std::from_chars_result>(r), v);
-#else
-                            fast_float::from_chars_result r;
-                            r = fast_float::from_chars(value_data_offset, value_data_end, v);
-                            return process_result(std::forward<fast_float::from_chars_result>(r), v);
-#endif
-                        }
-                    } else { // long double
-#ifdef _MSC_VER
+                auto const r = layout();
+                if (r.known && r.plain)
+                    return number<T>({b + r.lo, r.hi - r.lo});
+                // Quotes to collapse or an unusual trim policy: the number is parsed from the unquoted copy
+                return number<T>(operator unquoted_cell_string());
+            }
 
-                        T v;
-                        return process_result(std::from_chars(value_data_offset, value_data_end, v, std::chars_format::general), v);
-#else
-                        // long doubles are not supported in either std or fast_float libraries' from_chars() functions
-                        char *end;
-                        T v{strtold(value.data(), &end)};
-
-                        if (errno == ERANGE) {
-                            errno = 0;
-                            throw reader::exception("Range error, got inf: ", value);
-                        } else if ((v == 0.0f) && (end == value.data()))
-                            throw reader::exception("Argument isn't a number: ", value);
-                        else 
-                            return v;
-#endif
-                    }
-                }
+            /// Conversion to any arithmetic type that doesn't throw on bad input: check the result, the error code tells
+            /// why it failed (invalid_argument for empty and non-numeric cells, result_out_of_range)
+            template<typename T>
+            cast_result<T> try_as() const requires std::is_arithmetic_v<T> {
+                auto const r = layout();
+                if (r.known && r.plain)
+                    return try_number<T>({b + r.lo, r.hi - r.lo});
+                return try_number<T>(operator unquoted_cell_string());
             }
 
             /// Compares the contents of this cell/field to something string-like
-            bool operator==(std::string const &cs) const noexcept {
-                auto const this_value = operator unquoted_cell_string();
-                return std::equal(cs.begin(), cs.end(), this_value.begin(), this_value.end());
+            bool operator==(std::string_view cs) const noexcept {
+                auto const r = layout();
+                if (!r.known) {
+                    auto const this_value = operator unquoted_cell_string();
+                    return std::equal(cs.begin(), cs.end(), this_value.begin(), this_value.end());
+                }
+                if (r.plain)
+                    return cs == std::string_view{b + r.lo, r.hi - r.lo};
+                std::size_t j = 0;
+                for (auto k = r.lo; k < r.hi; ++k)
+                    if (kept(r, k) && (j == cs.size() || cs[j++] != b[k]))
+                        return false;
+                return j == cs.size();
             }
 
             /// Compares the contents of this cell/field to a numeric value of T
@@ -629,12 +1546,21 @@ namespace csv_co {
 
             /// Helper function. Note, it can highly depend on current trimming policy
             [[nodiscard]] bool empty() const {
-                return TrimPolicy::ret_trim(string()).empty();
+                auto const r = layout();
+                return r.known ? r.lo == r.hi : trimmed(string()).empty();
             }
 
             /// Helper cell size function
             [[nodiscard]] size_t size() const {
-                return TrimPolicy::ret_trim(string()).size();
+                auto const r = layout();
+                if (!r.known)
+                    return trimmed(string()).size();
+                if (r.plain)
+                    return r.hi - r.lo;
+                std::size_t n = 0;
+                for (auto k = r.lo; k < r.hi; ++k)
+                    n += kept(r, k);
+                return n;
             }
 
         };
@@ -642,8 +1568,15 @@ namespace csv_co {
         /// Gets pointer to the beginning of the CSV data  
         char const * data() const noexcept {
             char const *sa = nullptr;
+            // windows of a streamed archive go on right where the previous one ends, but the one rows start at
+            auto const continued = windows && windows->index() != start_window;
             std::visit([&](auto &&r) noexcept {
-                sa = !src_offset ? ((r.size() >= 3 && r[0] == '\xef' && r[1] == '\xbb' && r[2] == '\xbf') ? &r[3] : &r[0]) : &r[0] + src_offset;
+                if (continued)
+                    sa = &r[0];
+                else if (windows && start_window)
+                    sa = &r[0] + src_offset;
+                else
+                    sa = !src_offset ? ((r.size() >= 3 && r[0] == '\xef' && r[1] == '\xbb' && r[2] == '\xbf') ? &r[3] : &r[0]) : &r[0] + src_offset;
             }, src);
             return sa;
         }
@@ -691,18 +1624,26 @@ namespace csv_co {
             return fa;
         }
 
+        /// CSV data range: from the beginning of the CSV data up to the end of the source.
+        /// Rows skipped up to the end of a source not ending with a line break leave data() past the end.
+        std::string_view csv_view() const noexcept {
+            auto const finish = get_finish_address();
+            auto const begin = std::min(data(), finish);
+            return {begin, static_cast<std::size_t>(finish - begin)};
+        }
+
         /// Data chunk descriptor definition
         struct data_chunk {
             coroutine_stream_value_type const *begin;
             coroutine_stream_value_type const *end;
         };
 
-        /// Coroutine that sends every next data chunk
-        template<typename Range, std::size_t RangeSize>
-        auto data_chunk_sender(Range const &r) const noexcept -> generator<data_chunk> {
+        /// Coroutine that sends every next data chunk of a CSV range
+        template<std::size_t RangeSize>
+        auto data_chunk_sender(std::string_view csv) const noexcept -> generator<data_chunk> {
             data_chunk rs;
-            decltype(rs.begin) const end_r = std::addressof(r[0]) + r.size();
-            rs.begin = data();
+            decltype(rs.begin) const end_r = csv.data() + csv.size();
+            rs.begin = csv.data();
 
             while (rs.begin < end_r) {
                 rs.end = std::min(end_r, rs.begin + RangeSize);
@@ -718,6 +1659,13 @@ namespace csv_co {
                 tracer.fire();                     \
             }                                      \
         }
+#define control_max_field_size_n_macro(n)         \
+        if constexpr (!max_field_size_no_trace) {  \
+            for (auto i = (n); i; --i)             \
+                if (MaxFieldSize::reached()) {     \
+                    tracer.fire();                 \
+                }                                  \
+        }
 #define reset_max_field_size_macro                 \
         if constexpr (!max_field_size_no_trace) {  \
             MaxFieldSize::reset();                 \
@@ -726,6 +1674,16 @@ namespace csv_co {
         if constexpr (empty_rows_ignore) {                           \
             EmptyRows::collect_recent(*rs.begin, LineBreak::value);  \
         }
+#define skip_to_structural_macro                                             \
+        {                                                                    \
+            auto const next = scan.next(rs.begin + 1);                       \
+            control_max_field_size_n_macro(next - rs.begin)                  \
+            if constexpr (empty_rows_ignore) {                               \
+                if (next - rs.begin > 1)                                     \
+                    EmptyRows::collect_recent(next[-1], LineBreak::value);   \
+            }                                                                \
+            rs.begin = next;                                                 \
+        }
 #define check_empty_rows_macro(fn)                                 \
         if constexpr (empty_rows_ignore)                           \
         {                                                          \
@@ -736,21 +1694,32 @@ namespace csv_co {
             else tracer.fn(rs);                                    \
         } else
 
+        /// Characters the parser stops at, everything else is skipped by the vectorized scanner.
+        /// Carriage returns are needed by the empty rows policy only.
+        using structural_scanner = std::conditional_t<quoting
+            , std::conditional_t<empty_rows_ignore
+                , simd::scanner<Delimiter::value, Quote::value, LineBreak::value, '\r'>
+                , simd::scanner<Delimiter::value, Quote::value, LineBreak::value>>
+            , std::conditional_t<empty_rows_ignore
+                , simd::scanner<Delimiter::value, LineBreak::value, '\r'>
+                , simd::scanner<Delimiter::value, LineBreak::value>>>;
+
         /// Coroutine that parses CSV stream for all cases
-        template <typename Range, typename T>
-        auto data_chunk_parser(Range const & r, T && tracer) -> FSM_vector_cell_span< typename std::decay_t<T>::co_yield_type> {
+        template <typename T>
+        auto data_chunk_parser(std::string_view csv, T && tracer) -> FSM_vector_cell_span< typename std::decay_t<T>::co_yield_type> {
 
             coroutine_stream_const_pointer_type end;
             coroutine_stream_value_type last_value;
 
-            static std::vector<cell_span> tmp;
+            structural_scanner scan;
 
-            tracer.initialize(data());
-            end = std::addressof(r[0]) + r.size();
-            last_value = r.back();
+            tracer.initialize(csv.data());
+            end = csv.data() + csv.size();
+            last_value = csv.back();
 
             for (;;) {
                 auto rs = co_await data_chunk{};
+                scan.reset(rs.begin, rs.end);
                 while (rs.begin != rs.end) {
                     control_empty_rows_macro
                     switch (*rs.begin) {
@@ -762,6 +1731,11 @@ namespace csv_co {
                             continue;
 
                         case Quote::value:
+                            if constexpr (!quoting) {
+                                // just a field byte
+                                skip_to_structural_macro
+                                continue;
+                            }
                             quote_counter = 1;
                             ++rs.begin;
                             control_max_field_size_macro
@@ -788,8 +1762,8 @@ namespace csv_co {
                                         control_max_field_size_macro
                                     } else {
                                         [[likely]]
-                                        quote_counter += (Quote::value == *rs.begin++) ? 1 : 0; // branch-less
-                                        control_max_field_size_macro
+                                        quote_counter += (Quote::value == *rs.begin) ? 1 : 0; // branch-less
+                                        skip_to_structural_macro
                                     }
                                 }
                                 if (rs.begin == rs.end) {
@@ -805,6 +1779,7 @@ namespace csv_co {
                                     co_yield (tracer.co_yield_thing());
                                     tracer.cleanup_chunk_artifacts();
                                     rs = co_await data_chunk{};
+                                    scan.reset(rs.begin, rs.end);
                                 } else {
                                     [[likely]]
                                     break;
@@ -819,8 +1794,7 @@ namespace csv_co {
                             continue;
 
                         default:
-                            ++rs.begin;
-                            control_max_field_size_macro
+                            skip_to_structural_macro
                             continue;
                     }
                 }
@@ -837,9 +1811,194 @@ namespace csv_co {
             }
         }
 
+        /// Shows the empty rows policy what the state machine would have shown it from the field bytes:
+        /// only the trailing carriage returns matter, anything before them just resets the policy
+        void collect_field_tail(coroutine_stream_const_pointer_type b, coroutine_stream_const_pointer_type e) noexcept {
+            auto run = e;
+            while (run != b && run[-1] == '\r')
+                --run;
+            if (run != b)
+                EmptyRows::collect_recent(run[-1], LineBreak::value);
+            for (; run != e; ++run)
+                EmptyRows::collect_recent(*run, LineBreak::value);
+        }
+
+        /// What the two-stage parser carries from one chunk to the next
+        struct structural_index_state {
+            coroutine_stream_const_pointer_type end;
+            coroutine_stream_value_type last_value;
+
+            std::vector<std::uint64_t> & index = detail::chunk_index();
+            std::uint64_t in_quotes = 0;
+            // first byte after the latest structural character, and the first byte not yet seen by MaxFieldSize
+            coroutine_stream_const_pointer_type field_begin;
+            coroutine_stream_const_pointer_type traced_end;
+
+            explicit structural_index_state(std::string_view csv) noexcept
+                : end(csv.data() + csv.size())
+                , last_value(csv.empty() ? LineBreak::value : csv.back())
+                , field_begin(csv.data())
+                , traced_end(csv.data()) {}
+        };
+
+        /// Two-stage parsing of one data chunk: structural index first, tracer calls second
+        template <typename T>
+        void structural_index_chunk(structural_index_state & state, data_chunk rs, T && tracer) {
+            auto & [end, last_value, index, in_quotes, field_begin, traced_end] = state;
+            auto const chunk_begin = rs.begin;
+            auto const chunk_end = rs.end;
+
+            // stage 1, quote-free chunks need no quote parity
+            index.resize((chunk_end - chunk_begin + simd::block_size - 1) / simd::block_size);
+            if (quoting && (in_quotes || std::memchr(chunk_begin, Quote::value, chunk_end - chunk_begin)))
+                simd::index_unquoted<Quote::value, Delimiter::value, LineBreak::value>(chunk_begin, chunk_end, index.data(), in_quotes);
+            else
+                simd::index<Delimiter::value, LineBreak::value>(chunk_begin, chunk_end, index.data());
+
+            // stage 2
+            auto block = chunk_begin;
+            for (auto bits : index) {
+                while (bits) {
+                    rs.begin = block + std::countr_zero(bits);
+                    bits &= bits - 1;
+
+                    control_max_field_size_n_macro(rs.begin - traced_end)
+                    if constexpr (empty_rows_ignore) {
+                        collect_field_tail(field_begin, rs.begin);
+                        control_empty_rows_macro
+                    }
+
+                    if (*rs.begin == Delimiter::value) {
+                        tracer.on_delimiter(rs);
+                    } else {
+                        check_empty_rows_macro(on_lf)
+                        tracer.on_lf(rs);
+                    }
+                    reset_max_field_size_macro
+                    traced_end = field_begin = rs.begin;
+                }
+                block += simd::block_size;
+            }
+
+            rs.begin = chunk_end;
+            control_max_field_size_n_macro(chunk_end - traced_end)
+            traced_end = chunk_end;
+            if constexpr (empty_rows_ignore) {
+                if (rs.end == end)
+                    collect_field_tail(field_begin, rs.end);
+            }
+
+            if (rs.end == end && last_value != LineBreak::value) {
+                [[unlikely]];
+                check_empty_rows_macro(on_missed_lf)
+                tracer.on_missed_lf(rs);
+                reset_max_field_size_macro
+            }
+        }
+
+        /// Two-stage coroutine that parses CSV stream for all cases: structural index first, tracer calls second
+        template <typename T>
+        auto structural_index_parser(std::string_view csv, T && tracer) -> FSM_vector_cell_span< typename std::decay_t<T>::co_yield_type> {
+            structural_index_state state (csv);
+            tracer.initialize(csv.data());
+
+            for (;;) {
+                structural_index_chunk(state, co_await data_chunk{}, tracer);
+                co_yield (tracer.co_yield_thing());
+                tracer.cleanup_chunk_artifacts();
+            }
+        }
+
+        /// Two-stage parser driven by a plain call per chunk, with no coroutine frame behind it.
+        /// Has the interface of the parsing coroutines: send() a chunk, then take what the tracer yields.
+        template <typename T>
+        class direct_parser {
+            using co_yield_type = typename std::decay_t<T>::co_yield_type;
+
+            reader & r;
+            T tracer;
+            structural_index_state state;
+            co_yield_type value {};
+            // chunk artifacts are cleaned up when the next chunk comes, after the consumer has seen them
+            bool dirty = false;
+
+        public:
+            direct_parser(reader & r, std::string_view csv, T && tracer)
+                : r(r), tracer(std::forward<T>(tracer)), state(csv) {
+                this->tracer.initialize(csv.data());
+            }
+
+            void send(data_chunk rs) {
+                if (dirty)
+                    tracer.cleanup_chunk_artifacts();
+                r.structural_index_chunk(state, rs, tracer);
+                value = tracer.co_yield_thing();
+                dirty = true;
+            }
+
+            co_yield_type operator()() {
+                co_yield_type tmp{};
+                std::swap(tmp, value);
+                return tmp;
+            }
+        };
+
+        /// Data chunks of a CSV range, handed out by a plain iterator
+        template<std::size_t RangeSize>
+        class data_chunk_range {
+            std::string_view csv;
+
+        public:
+            struct iterator {
+                data_chunk rs;
+                coroutine_stream_const_pointer_type end_r;
+
+                data_chunk const & operator*() const noexcept { return rs; }
+
+                iterator & operator++() noexcept {
+                    rs.begin = rs.end;
+                    rs.end = rs.begin + std::min(static_cast<std::size_t>(end_r - rs.begin), RangeSize);
+                    return *this;
+                }
+
+                bool operator==(std::default_sentinel_t) const noexcept { return rs.begin >= end_r; }
+            };
+
+            explicit data_chunk_range(std::string_view csv) noexcept : csv(csv) {}
+
+            iterator begin() const noexcept {
+                auto const end_r = csv.data() + csv.size();
+                return {{csv.data(), csv.data() + std::min(csv.size(), RangeSize)}, end_r};
+            }
+
+            std::default_sentinel_t end() const noexcept { return {}; }
+        };
+
+        /// Data chunks of a CSV range for the chosen engine
+        template<std::size_t RangeSize>
+        auto chunk_source(std::string_view csv) const noexcept {
+            if constexpr (Engine::coroutines)
+                return data_chunk_sender<RangeSize>(csv);
+            else
+                return data_chunk_range<RangeSize>(csv);
+        }
+
+        /// Parser of the chosen engine. The CSV range must begin at a row start.
+        template <typename T>
+        auto chunk_parser(std::string_view csv, T && tracer) {
+            if constexpr (!Engine::coroutines)
+                return direct_parser<T>(*this, csv, std::forward<T>(tracer));
+            else if constexpr (Engine::two_stage)
+                return structural_index_parser(csv, std::forward<T>(tracer));
+            else
+                return data_chunk_parser(csv, std::forward<T>(tracer));
+        }
+
 #undef control_max_field_size_macro
+#undef control_max_field_size_n_macro
 #undef reset_max_field_size_macro
 #undef control_empty_rows_macro
+#undef skip_to_structural_macro
 #undef check_empty_rows_macro
 
         struct v_field_span_caller_tag;
@@ -890,7 +2049,7 @@ namespace csv_co {
 
         /// Implementation of the span iteration mode
         template <typename SpanCallerTag, std::size_t ParseChunkSize, template <class> class ... Bases>
-        void run_spans_impl()  {
+        void run_spans_impl(auto & hfs_cb, auto & vfs_cb, auto & new_row_cb)  {
 
             /// Specific methods implementer for parsing coroutine
             class tracer : public Bases<tracer>... {
@@ -918,19 +2077,16 @@ namespace csv_co {
 
             tracer t;
 
-            std::visit([&](auto&& arg) {
-                unsigned cls;
-                if constexpr (std::is_same_v<SpanCallerTag, hv_field_span_caller_tag>)
-                    cls = cols<ParseChunkSize>();
-
-                auto source = data_chunk_sender<decltype(arg), ParseChunkSize>(arg);
-                auto p = data_chunk_parser(arg, t);
+            constexpr bool with_header = std::is_same_v<SpanCallerTag, hv_field_span_caller_tag>;
+            // header fields not handed over yet
+            std::size_t header_fields = 0;
+            if constexpr (with_header)
+                header_fields = cols<ParseChunkSize>();
 
-                std::function<void(cell_span & span)> hfs_or_vfs_cb = [&cls, this, &hfs_or_vfs_cb] (auto & elem) {
-                    hfs_cb(elem);
-                    if (!--cls)
-                        hfs_or_vfs_cb = vfs_cb;
-                };
+            over_windows([&] {
+                auto const finish = get_finish_address();
+                auto source = chunk_source<ParseChunkSize>(csv_view());
+                auto p = chunk_parser(csv_view(), t);
 
                 for (auto const & b: source) {
                     p.send(b);
@@ -939,28 +2095,34 @@ namespace csv_co {
 
                     auto && v = *p();
                     for (auto && elem : v) {
-                        char is_lf;
-                        if constexpr (std::is_same_v<SpanCallerTag, v_field_span_caller_tag>)
-                            vfs_cb((is_lf = *elem.e, elem));
-                        else if constexpr (std::is_same_v<SpanCallerTag, hv_field_span_caller_tag>)
-                            hfs_or_vfs_cb((is_lf = *elem.e, elem));
-
-                        if (is_lf == LineBreak::value)
+                        bool const is_lf = elem.e != finish && *elem.e == LineBreak::value;
+                        if constexpr (with_header) {
+                            if (header_fields) {
+                                [[unlikely]]
+                                --header_fields;
+                                hfs_cb(elem);
+                            } else
+                                vfs_cb(elem);
+                        } else
+                            vfs_cb(elem);
+
+                        if (is_lf)
                             new_row_cb();
                     }
                 }
 
-                if (arg.back() != LineBreak::value)
+                if (finish[-1] != LineBreak::value)
                     new_row_cb();
-
-            }, src);
+            });
         }
 
-        // TODO: make a local lambda
-        void iterate(auto span) const {
-            unsigned index = 0;
+        /// Indexes the names of a header row
+        void index_header(auto const & span) {
+            std::vector<cell_string> names;
+            names.reserve(span.size());
             for (auto const & elem : span)
-                col_name_2_index_map[elem.operator cell_string()] = index++;
+                names.emplace_back(elem.operator cell_string());
+            header_names.assign(names);
         }
 
         class v_row_span_caller_tag;
@@ -968,10 +2130,190 @@ namespace csv_co {
 
         /// Implementation of the rows iteration mode
         template <typename Tag, std::size_t ParseChunkSize, template<class> class ... Bases>
-        void run_rows_impl(auto cols) {
+        void run_rows_impl(auto cols, auto & hrs_cb, auto & vrs_cb) {
 
-            /// Specific methods implementer for parsing coroutine
+            /// Specific methods implementer for parsing coroutine.
+            /// Spans go to a ring of row slots: a row always takes cols adjacent spans and a slot never wraps, so the
+            /// row left incomplete by a chunk stays where it is, and the ring stops growing once a chunk fits in.
             class tracer : public Bases<tracer>... {
+            public:
+                cell_span span;
+            private:
+                std::vector<cell_span> ring;
+                size_t cols;
+                // first span not handed over
+                size_t head = 0;
+                // next span to write, and where the free room in front of it ends
+                cell_span * w;
+                cell_span * limit;
+                // spans written at the ring beginning, after the ones up to the ring end
+                bool wrapped = false;
+
+                inline void push(cell_string::const_pointer e) {
+                    if (w == limit) {
+                        [[unlikely]]
+                        make_room();
+                    }
+                    *w++ = cell_span{span.b, e};
+                }
+
+                void make_room() {
+                    if (!wrapped && head) {
+                        w = ring.data();
+                        limit = ring.data() + head;
+                        wrapped = true;
+                        return;
+                    }
+                    // full: the spans get into a twice as large ring, in order
+                    std::vector<cell_span> bigger (ring.size() * 2);
+                    auto const it = std::copy(ring.begin() + static_cast<std::ptrdiff_t>(head), ring.end(), bigger.begin());
+                    auto const end = std::copy(ring.data(), wrapped ? w : ring.data(), it);
+                    ring.swap(bigger);
+                    head = 0;
+                    w = ring.data() + (end - ring.begin());
+                    limit = ring.data() + ring.size();
+                    wrapped = false;
+                }
+
+                inline std::size_t spans() const noexcept {
+                    return wrapped ? ring.size() - head + static_cast<std::size_t>(w - ring.data())
+                                   : static_cast<std::size_t>(w - ring.data()) - head;
+                }
+
+            public:
+                using co_yield_type = tracer *;
+
+                /// The ring is sized for the rows of an average chunk (of 8-byte fields) to begin with
+                tracer (std::size_t cols, std::size_t chunk_size)
+                    : ring (cols * (std::max(chunk_size / 8, cols) / cols + 1)), cols (cols) {}
+
+                inline void initialize(char const* ptr) noexcept {
+                    head = 0;
+                    w = ring.data();
+                    limit = ring.data() + ring.size();
+                    wrapped = false;
+                    span.b = ptr;
+                }
+                inline void on_delimiter (data_chunk & rs) {
+                    push(rs.begin);
+                    span.b = ++rs.begin;
+                }
+                inline void on_lf (data_chunk & rs) {
+                    push(rs.begin);
+                    span.b = ++rs.begin;
+                }
+                inline void on_missed_lf (data_chunk & rs) {
+                    push(span.b + (rs.end - span.b));
+                }
+                inline co_yield_type co_yield_thing() noexcept { return this; }
+                inline void cleanup_chunk_artifacts() noexcept {
+                    if (spans() < cols)
+                        return;
+                    head += rows() * cols;
+                    if (wrapped) {
+                        if (head >= ring.size()) {
+                            head -= ring.size();
+                            limit = ring.data() + ring.size();
+                            wrapped = false;
+                        } else
+                            limit = ring.data() + head;
+                    }
+                }
+
+                /// Complete rows in the ring
+                inline std::size_t rows() const noexcept { return spans() / cols; }
+
+                /// Beginning of a complete row, counting from the earliest one
+                inline auto row_begin(std::size_t row) noexcept {
+                    auto const pos = head + row * cols;
+                    return ring.begin() + static_cast<std::ptrdiff_t>(pos < ring.size() ? pos : pos - ring.size());
+                }
+            };
+
+            if (!cols)
+                throw implementation_exception("An incorrect assumption, columns number is zero.");
+
+            tracer t (cols, ParseChunkSize);
+
+            // the header row is not handed over yet
+            bool header_row = std::is_same_v<Tag, hv_row_span_caller_tag>;
+
+            over_windows([&] {
+                auto source = chunk_source<ParseChunkSize>(csv_view());
+                auto p = chunk_parser(csv_view(), t);
+
+                for (auto const & b: source) {
+                    p.send(b);
+
+                    fire_notification_handler(t);
+
+                    auto & ring = *p();
+                    for (auto row = 0u, rows = ring.rows(); row != rows; ++row) {
+                        row_span span (ring.row_begin(row), cols, &header_names);
+                        if constexpr (std::is_same_v<Tag, hv_row_span_caller_tag>) {
+                            if (header_row) {
+                                [[unlikely]]
+                                header_row = false;
+                                index_header(span);
+                                hrs_cb(span);
+                                continue;
+                            }
+                        }
+                        vrs_cb(span);
+                    }
+                }
+            });
+        }
+
+        /// Calls f(i), i in [0, n), on n threads and waits for all of them. f must not throw.
+        static void on_threads(std::size_t n, auto const & f) {
+            std::vector<std::thread> threads;
+            try {
+                for (std::size_t i = 0; i != n; ++i)
+                    threads.emplace_back(f, i);
+            } catch (...) {
+                for (auto & t : threads)
+                    t.join();
+                throw;
+            }
+            for (auto & t : threads)
+                t.join();
+        }
+
+        /// Splits a CSV range into at most n row-aligned slices. The byte ranges are summarized on n threads, each one
+        /// speculating on both quote states it may begin in; then the real states are chained from the first range on,
+        /// which picks the consistent row start of each range.
+        auto row_aligned_slices(std::string_view csv, unsigned n) const -> std::vector<std::string_view> {
+            n = static_cast<unsigned>(std::clamp<std::size_t>(n, 1, csv.size()));
+            auto const step = csv.size() / n;
+            auto const end = csv.data() + csv.size();
+
+            std::vector<simd::range_summary> summaries(n);
+            on_threads(n, [&](std::size_t i) noexcept {
+                auto const b = csv.data() + step * i;
+                summaries[i] = simd::summarize<Quote::value, LineBreak::value, quoting>(b, (i + 1 == n) ? end : b + step);
+            });
+
+            std::vector<std::string_view> slices;
+            auto begin = csv.data();
+            bool in_quotes = false;
+            for (auto i = 1u; i != n; ++i) {
+                in_quotes ^= summaries[i - 1].odd_quotes;
+                if (auto const lf = summaries[i].first_break[in_quotes]; lf && lf + 1 != end) {
+                    slices.emplace_back(begin, lf + 1 - begin);
+                    begin = lf + 1;
+                }
+            }
+            slices.emplace_back(begin, end - begin);
+            return slices;
+        }
+
+        /// Implementation of the parallel span and row iteration modes
+        template <typename Tag, std::size_t ParseChunkSize>
+        void run_parallel_impl(unsigned threads, delivery order, auto & header_cb, auto & value_cb, auto & new_row_cb) {
+
+            /// Specific methods implementer for parsing coroutine
+            class tracer {
             public:
                 cell_span span;
             private:
@@ -1001,43 +2343,174 @@ namespace csv_co {
                 }
             };
 
-            tracer t (cols);
+            constexpr bool rows_mode = std::is_same_v<Tag, v_row_span_caller_tag> || std::is_same_v<Tag, hv_row_span_caller_tag>;
+            constexpr bool with_header = std::is_same_v<Tag, hv_row_span_caller_tag> || std::is_same_v<Tag, hv_field_span_caller_tag>;
+            // batches a worker may get ahead of the ordered delivery
+            constexpr std::size_t max_batches = 4;
 
-            std::function<void(row_span & r)> hrs_or_vrs_cb = [this, &hrs_or_vrs_cb] (auto & span) {
-                iterate(span);
-                hrs_cb(span);
-                hrs_or_vrs_cb = vrs_cb;
+            std::size_t const cls = (rows_mode || with_header) ? cols<ParseChunkSize>() : 1;
+            if (rows_mode && !cls)
+                throw implementation_exception("An incorrect assumption, columns number is zero.");
+
+            // parses a row-aligned slice, handing the complete rows of each chunk to consume() while it agrees
+            auto const parse = [this](std::string_view slice, std::size_t slice_cols, auto && consume) {
+                tracer t (slice_cols);
+                auto source = chunk_source<ParseChunkSize>(slice);
+                auto p = chunk_parser(slice, t);
+                for (auto const & b: source) {
+                    p.send(b);
+                    auto && v = *p();
+                    if (!consume(v, v.size() / slice_cols * slice_cols))
+                        return;
+                }
             };
 
-            std::visit([&](auto&& arg) {
-                if (!cols)
-                    throw implementation_exception("An incorrect assumption, columns number is zero.");
+            // the header row is handed over once, in the first window
+            bool header_due = with_header;
 
-                auto source = data_chunk_sender<decltype(arg), ParseChunkSize>(arg);
-                auto p = data_chunk_parser(arg, t);
+            over_windows([&] {
+                auto const finish = get_finish_address();
+                auto csv = csv_view();
 
-                for (auto const & b: source) {
-                    p.send(b);
+                auto const deliver = [&](std::vector<cell_span> & v, std::size_t elems) {
+                    if constexpr (rows_mode) {
+                        for (auto row = 0u; row != elems / cls; ++row) {
+                            row_span span (v.begin() + cls * row, cls, &header_names);
+                            value_cb(span);
+                        }
+                    } else {
+                        for (auto i = 0u; i != elems; ++i) {
+                            value_cb(v[i]);
+                            if (v[i].e != finish && *v[i].e == LineBreak::value)
+                                new_row_cb();
+                        }
+                    }
+                };
 
-                    fire_notification_handler(t);
+                if constexpr (with_header) {
+                    if (std::exchange(header_due, false)) {
+                        parse(csv, cls, [&](auto & v, std::size_t elems) {
+                            if (!elems)
+                                return true;
+                            row_span span (v.begin(), cls, &header_names);
+                            if constexpr (rows_mode) {
+                                index_header(span);
+                                header_cb(span);
+                            } else {
+                                for (auto & elem : span)
+                                    header_cb(elem);
+                                if (span.back().e != finish)
+                                    new_row_cb();
+                            }
+                            csv.remove_prefix(std::min<std::size_t>(csv.size(), span.back().e + 1 - csv.data()));
+                            return false;
+                        });
+                    }
+                }
 
-                    auto && v = *p();
-                    if (auto const rows = v.size()/cols) {
-                        for (auto row = 0u; row != rows; ++row) {
-                            row_span span (v.begin()+cols*row, cols);
-                            if constexpr (std::is_same_v<Tag, v_row_span_caller_tag>)
-                                vrs_cb(span);
-                            else if constexpr (std::is_same_v<Tag, hv_row_span_caller_tag>)
-                                hrs_or_vrs_cb(span);
+                if (!csv.empty()) {
+                    auto const slices = row_aligned_slices(csv, threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+
+                    struct channel {
+                        std::mutex m;
+                        std::condition_variable cv;
+                        std::deque<std::vector<cell_span>> batches;
+                        bool done = false;
+                    };
+                    std::vector<channel> channels (order == delivery::ordered ? slices.size() : 0);
+
+                    std::atomic<bool> stop {false};
+                    std::exception_ptr error;
+                    std::mutex error_mutex;
+                    auto const fail = [&] {
+                        {
+                            std::lock_guard lock (error_mutex);
+                            if (!error)
+                                error = std::current_exception();
                         }
+                        stop = true;
+                        for (auto & ch : channels) {
+                            std::lock_guard lock (ch.m);
+                            ch.cv.notify_all();
+                        }
+                    };
+
+                    auto const work = [&](std::size_t i) {
+                        try {
+                            parse(slices[i], cls, [&](auto & v, std::size_t elems) {
+                                if (stop)
+                                    return false;
+                                if (order == delivery::unordered) {
+                                    deliver(v, elems);
+                                    return true;
+                                }
+                                auto & ch = channels[i];
+                                std::unique_lock lock (ch.m);
+                                ch.cv.wait(lock, [&] { return ch.batches.size() < max_batches || stop; });
+                                if (stop)
+                                    return false;
+                                ch.batches.emplace_back(v.begin(), v.begin() + elems);
+                                ch.cv.notify_all();
+                                return true;
+                            });
+                        } catch (...) {
+                            fail();
+                        }
+                        if (order == delivery::ordered) {
+                            std::lock_guard lock (channels[i].m);
+                            channels[i].done = true;
+                            channels[i].cv.notify_all();
+                        }
+                    };
+
+                    std::vector<std::thread> workers;
+                    try {
+                        for (auto i = 0u; i != slices.size(); ++i)
+                            workers.emplace_back(work, i);
+                    } catch (...) {
+                        fail();
                     }
+
+                    if (order == delivery::ordered) {
+                        try {
+                            for (auto & ch : channels) {
+                                for (;;) {
+                                    std::vector<cell_span> batch;
+                                    {
+                                        std::unique_lock lock (ch.m);
+                                        ch.cv.wait(lock, [&] { return !ch.batches.empty() || ch.done || stop; });
+                                        if (stop || ch.batches.empty())
+                                            break;
+                                        batch = std::move(ch.batches.front());
+                                        ch.batches.pop_front();
+                                        ch.cv.notify_all();
+                                    }
+                                    deliver(batch, batch.size());
+                                }
+                                if (stop)
+                                    break;
+                            }
+                        } catch (...) {
+                            fail();
+                        }
+                    }
+
+                    for (auto & w : workers)
+                        w.join();
+                    if (error)
+                        std::rethrow_exception(error);
                 }
-            }, src);
+
+                if constexpr (!rows_mode) {
+                    if (finish[-1] != LineBreak::value)
+                        new_row_cb();
+                }
+            });
         }
 
         /// Implementation of the columns getter
         template <std::size_t ParseChunkSize = default_chunk_size, template<class> class ... Bases>
-        [[nodiscard]] auto cols_impl() noexcept (max_field_size_no_trace) -> std::size_t {
+        [[nodiscard]] auto cols_impl() -> std::size_t {
 
             /// Specific methods implementer for parsing coroutine
             class tracer : public Bases<tracer>... {
@@ -1059,10 +2532,11 @@ namespace csv_co {
 
             tracer t;
 
-            auto cols {0};
-            std::visit([&](auto&& arg) noexcept (max_field_size_no_trace) {
-                auto source = data_chunk_sender<decltype(arg), ParseChunkSize>(arg);
-                auto p = data_chunk_parser(arg, t);
+            std::size_t cols = 0;
+            // the first window holds the first row
+            over_windows([&] {
+                auto source = chunk_source<ParseChunkSize>(csv_view());
+                auto p = chunk_parser(csv_view(), t);
                 for (auto const & b: source) {
                     p.send(b);
                     auto && v = p();
@@ -1071,16 +2545,17 @@ namespace csv_co {
 
                     if (v.has_value()) {
                         cols = v.value();
-                        return;
+                        break;
                     }
                 }
-            }, src);
+                return false;
+            });
             return cols;
         }
 
         /// Implementation of the rows getter
         template <std::size_t ParseChunkSize=default_chunk_size, template <class> class ... Bases>
-        [[nodiscard]] auto rows_impl() noexcept -> std::size_t {
+        [[nodiscard]] auto rows_impl() -> std::size_t {
 
             /// Specific methods implementer for parsing coroutine
             class tracer : public Bases<tracer>... {
@@ -1089,7 +2564,7 @@ namespace csv_co {
             public:
                 tracer() : lines(0) {}
                 using co_yield_type = decltype(proxy_lines);
-                inline void initialize(char const * const) noexcept {}
+                inline void initialize(char const * const) noexcept { proxy_lines = std::nullopt; }
                 inline void on_delimiter (data_chunk & rs) noexcept { rs.begin++; }
                 inline void on_lf (data_chunk & rs) noexcept { rs.begin++; lines++; }
                 inline void on_missed_lf (data_chunk&) noexcept { lines++; }
@@ -1099,10 +2574,10 @@ namespace csv_co {
 
             tracer t;
 
-            auto rows {0};
-            std::visit([&](auto&& arg) noexcept {
-                auto source = data_chunk_sender<decltype(arg), ParseChunkSize>(arg);
-                auto p = data_chunk_parser(arg, t);
+            std::size_t rows {0};
+            over_windows([&] {
+                auto source = chunk_source<ParseChunkSize>(csv_view());
+                auto p = chunk_parser(csv_view(), t);
                 for (auto const & b: source) {
                     p.send(b);
                     auto && v = p();
@@ -1112,10 +2587,44 @@ namespace csv_co {
                     if (v.has_value())
                         rows += v.value();
                 }
-            }, src);
+            });
             return rows;
         }
 
+        /// Implementation of the rows getter that counts unquoted line breaks of n byte ranges, not involving parsers.
+        /// Every range is counted for both quote states it may begin in, the real states are chained afterwards.
+        [[nodiscard]] auto count_rows_impl(unsigned threads) -> std::size_t {
+            std::size_t total = 0;
+            over_windows([&] {
+                auto const csv = csv_view();
+                if (csv.empty())
+                    return;
+
+                auto const n = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, csv.size()));
+                auto const step = csv.size() / n;
+                auto const end = csv.data() + csv.size();
+
+                std::vector<simd::break_count> counts(n);
+                auto const count = [&](std::size_t i) noexcept {
+                    auto const b = csv.data() + step * i;
+                    counts[i] = simd::count_breaks<Quote::value, LineBreak::value, quoting>(b, (i + 1 == n) ? end : b + step);
+                };
+                if (n == 1)
+                    count(0);
+                else
+                    on_threads(n, count);
+
+                std::size_t rows = (csv.back() != LineBreak::value);
+                bool in_quotes = false;
+                for (auto const & c : counts) {
+                    rows += c.breaks[in_quotes];
+                    in_quotes ^= c.odd_quotes;
+                }
+                total += rows;
+            });
+            return total;
+        }
+
         /// Implementation of the validation
         template <std::size_t ParseChunkSize=default_chunk_size, template<class> class ... Bases>
         [[nodiscard]] auto validate_impl() -> reader& {
@@ -1126,7 +2635,7 @@ namespace csv_co {
                 std::vector<std::size_t> cols_vector;
             public:
                 using co_yield_type = decltype(&cols_vector);
-                inline void initialize(char const * const) noexcept { cols = 0;}
+                inline void initialize(char const * const) noexcept { cols = 0; cols_vector.clear(); }
                 inline void on_delimiter (data_chunk & rs) noexcept { rs.begin++; cols++;}
                 inline void on_lf (data_chunk & rs) { rs.begin++; cols_vector.push_back(++cols); cols = 0; }
                 inline void on_missed_lf (data_chunk&) { cols_vector.push_back(++cols); cols = 0; }
@@ -1172,33 +2681,109 @@ namespace csv_co {
                 state_2(v);
             };
 
-            std::visit([&](auto&& arg) {
-                auto source = data_chunk_sender<decltype(arg), ParseChunkSize>(arg);
-                auto p = data_chunk_parser(arg, t);
-                state_m = state_1;
+            state_m = state_1;
 
+            over_windows([&] {
+                auto source = chunk_source<ParseChunkSize>(csv_view());
+                auto p = chunk_parser(csv_view(), t);
                 for (auto const & b: source) {
                     p.send(b);
                     auto && v = *p();
                     fire_notification_handler(t);
                     state_m(v);
                 }
+            });
 
-                if (validated_errors.tellp())
-                    throw exception(validated_errors.str());
+            if (validated_errors.tellp())
+                throw exception(validated_errors.str());
 
-                if (!orig_cols)
-                    throw exception ("Use of \"move from\" state object");
+            if (!orig_cols)
+                throw exception ("Use of \"move from\" state object");
 
-                validated_shape = validated_shape_t(rows_accumulator - 1, orig_cols);
-            }, src);
+            validated_shape = validated_shape_t(rows_accumulator - 1, orig_cols);
+
+            return *this;
+        }
 
+        /// Implementation of the parallel validation: the column counts of row-aligned slices are checked on separate
+        /// threads, then the mismatches are merged into the very messages the serial validation makes
+        template <std::size_t ParseChunkSize=default_chunk_size>
+        [[nodiscard]] auto validate_parallel_impl(unsigned threads) -> reader& {
+
+            /// Specific methods implementer for parsing coroutine
+            class tracer {
+                std::size_t cols = 0;
+                std::size_t expected_cols;
+            public:
+                std::size_t rows = 0;
+                /// Row number within the slice and columns found
+                std::vector<std::pair<std::size_t, std::size_t>> mismatches;
+
+                explicit tracer (std::size_t expected_cols) : expected_cols (expected_cols) {}
+                using co_yield_type = decltype(&mismatches);
+                inline void initialize(char const * const) noexcept { cols = 0;}
+                inline void on_delimiter (data_chunk & rs) noexcept { rs.begin++; cols++;}
+                inline void on_lf (data_chunk & rs) { rs.begin++; on_missed_lf(rs); }
+                inline void on_missed_lf (data_chunk&) {
+                    if (++cols != expected_cols)
+                        mismatches.emplace_back(rows, cols);
+                    ++rows;
+                    cols = 0;
+                }
+                inline co_yield_type co_yield_thing() noexcept { return &mismatches; }
+                inline void cleanup_chunk_artifacts() noexcept {}
+            };
+
+            auto const orig_cols = cols<ParseChunkSize>();
+            if (!orig_cols)
+                throw exception ("Use of \"move from\" state object");
+
+            std::ostringstream validated_errors;
+            std::string prefix;
+            std::size_t rows_accumulator = 1;
+
+            over_windows([&] {
+                auto const slices = row_aligned_slices(csv_view(), threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+                std::vector<tracer> tracers (slices.size(), tracer(orig_cols));
+                std::vector<std::exception_ptr> errors (slices.size());
+
+                on_threads(slices.size(), [&](std::size_t i) noexcept {
+                    try {
+                        auto source = chunk_source<ParseChunkSize>(slices[i]);
+                        auto p = chunk_parser(slices[i], tracers[i]);
+                        for (auto const & b: source) {
+                            p.send(b);
+                            (void) p();
+                        }
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+
+                for (auto const & e : errors)
+                    if (e)
+                        std::rethrow_exception(e);
+
+                for (auto const & t : tracers) {
+                    for (auto const & [row, found] : t.mismatches) {
+                        validated_errors << prefix << '\"' << "Line " << rows_accumulator + row << ": Expected " << orig_cols << " columns, found " << found << " columns" << '\"';
+                        prefix = ',';
+                    }
+                    rows_accumulator += t.rows;
+                }
+            });
+
+            if (validated_errors.tellp())
+                throw exception(validated_errors.str());
+
+            validated_shape = validated_shape_t(rows_accumulator - 1, orig_cols);
             return *this;
         }
 
         /// Implementation of the skip rows facility
         template <std::size_t ParseChunkSize=default_chunk_size, template <class> class ... Bases>
-        [[nodiscard]] auto skip_rows_impl(std::size_t rows_to_skip, std::size_t offset) noexcept -> std::size_t {
+        /// Skips rows of csv_view(): the offset the rows left start at, 0 and the rows left to skip if it runs out first
+        [[nodiscard]] auto skip_rows_impl(std::size_t & rows_to_skip, std::size_t offset) -> std::size_t {
 
             /// Specific methods implementer for parsing coroutine
             class tracer : public Bases<tracer>... {
@@ -1230,45 +2815,143 @@ namespace csv_co {
                 inline void cleanup_chunk_artifacts() noexcept {
                     if (proxy_src_offset.has_value()) proxy_src_offset = std::nullopt;
                 }
+                [[nodiscard]] std::size_t rows_left() const noexcept { return rows_to_skip_; }
 
             };
 
             tracer t (rows_to_skip, offset);
 
-            auto new_offset {0u};
-            std::visit([&](auto&& arg) noexcept {
-                auto source = data_chunk_sender<decltype(arg), ParseChunkSize>(arg);
-                auto p = data_chunk_parser(arg, t);
-                for (auto const & b: source) {
-                    p.send(b);
-                    auto && v = p();
-                    if (v.has_value()) {
-                        new_offset = v.value();
-                        return;
-                    }
+            auto source = chunk_source<ParseChunkSize>(csv_view());
+            auto p = chunk_parser(csv_view(), t);
+            for (auto const & b: source) {
+                p.send(b);
+                auto && v = p();
+                if (v.has_value()) {
+                    rows_to_skip = 0;
+                    return v.value();
                 }
-            }, src);
-            return new_offset;
+            }
+            rows_to_skip = t.rows_left();
+            return 0;
         }
 
         // Multi-source CSV
         std::variant<mio::ro_mmap, std::string, std::vector<char>> src;
 
+        using row_windows_type = detail::row_windows<Quote::value, LineBreak::value, quoting>;
+        /// Streamed archive, src holding the window of it parsed. None for sources in memory.
+        std::unique_ptr<row_windows_type> windows;
+
+        /// Size a window of a streamed archive gets to before it is cut at a row end
+        constexpr static std::size_t stream_window_size = std::size_t{1} << 20;
+
         using validated_shape_t = std::pair<std::size_t, std::size_t>;
         std::optional<validated_shape_t> validated_shape = std::nullopt;
 
         size_t src_offset = 0;
 
-        mutable new_row_cb_t new_row_cb;
+        /// Window of a streamed archive that rows start at, after skipped ones: src_offset is within it
+        std::size_t start_window = 0;
 
-        mutable header_field_span_cb_t hfs_cb;
-        mutable value_field_span_cb_t vfs_cb;
-
-        mutable header_row_span_cb_t hrs_cb;
-        mutable value_row_span_cb_t vrs_cb;
         mutable notification_cb_t notification_cb;
 
-        inline static std::unordered_map<cell_string, unsigned> col_name_2_index_map;
+        /// Names of the header columns, indexed by the header row iteration or by column()
+        detail::name_index header_names;
+
+        /// Number of value rows, if validation has counted the rows, to reserve bulk casts' output. Zero otherwise.
+        [[nodiscard]] std::size_t value_rows_hint(bool has_header) const noexcept {
+            if (!validated_shape.has_value())
+                return 0;
+            auto const rows = validated_shape.value().first;
+            return rows - (has_header && rows);
+        }
+
+        /// Calls v for every value row, skipping the header row if there is one
+        template <std::size_t ParseChunkSize, typename V>
+        void run_value_rows(bool has_header, V && v) {
+            if (has_header)
+                run_rows<ParseChunkSize>([](row_span &) {}, v);
+            else
+                run_rows<ParseChunkSize>(v);
+        }
+
+        static void check_column(row_span const & rs, column_handle column) {
+            if (column.index >= rs.size())
+                throw exception("No such column: ", column.index);
+        }
+
+        /// Streams an archive: src shows the first window of it
+        void open_stream(std::unique_ptr<detail::byte_stream> s) {
+            windows = std::make_unique<row_windows_type>(std::move(s), stream_window_size);
+            src = std::vector<char>{};
+            if (!windows->next(std::get<std::vector<char>>(src)))
+                throw exception (arg_is_empty);
+        }
+
+        /// Brings a streamed archive back to the window its rows start at, the first one unless rows are skipped
+        void to_first_window() {
+            if (windows && windows->index() != start_window) {
+                auto & window = std::get<std::vector<char>>(src);
+                windows->rewind(window);
+                while (windows->index() != start_window)
+                    windows->next(window);
+            }
+        }
+
+        /// Calls f() for the whole source: a source in memory at once, a streamed archive once per window of its whole
+        /// rows, csv_view() showing the window. f() may return false for no more windows.
+        template <typename F>
+        void over_windows(F && f) {
+            auto const go_on = [&f] {
+                if constexpr (std::is_void_v<std::invoke_result_t<F &>>) {
+                    f();
+                    return true;
+                } else
+                    return static_cast<bool>(f());
+            };
+            if (!windows) {
+                go_on();
+                return;
+            }
+            to_first_window();
+            while (go_on() && windows->next(std::get<std::vector<char>>(src))) {}
+        }
+
+        /// Makes the source writable in place: strings and decompressed archives already are, files get mapped privately
+        void make_source_writable() {
+            if (auto * const m = std::get_if<mio::ro_mmap>(&src); m && !m->is_private()) {
+                std::error_code mmap_error;
+                m->remap_private(mmap_error);
+                if (mmap_error)
+                    throw exception (mmap_error.message());
+            }
+        }
+
+        /// Unquotes and trims a field within the (writable) source, collapsing escaped quotes to the left
+        static std::string_view unescape(cell_span const & span) {
+            auto const r = span.layout();
+            auto const p = const_cast<char *>(span.b);
+            if (r.known) {
+                if (r.plain)
+                    return {p + r.lo, r.hi - r.lo};
+                auto w = p + r.lo;
+                for (auto k = r.lo; k < r.hi; ++k)
+                    if (span.kept(r, k))
+                        *w++ = p[k];
+                return {p + r.lo, static_cast<std::size_t>(w - (p + r.lo))};
+            }
+            // A custom trim policy: its value is copied over the field
+            auto const value = span.operator unquoted_cell_string();
+            if (value.size() > span.raw_string_view().size())
+                throw exception ("The trim policy lengthens the field, it can't be unescaped in place: ", value);
+            if (!value.empty())
+                std::memcpy(p, value.data(), value.size());
+            return {p, value.size()};
+        }
+
+        static column_handle to_column(column_handle column) noexcept { return column; }
+        static column_handle to_column(std::size_t index) noexcept { return {index}; }
+        column_handle to_column(std::string_view name) { return column(name); }
         static constexpr char const * const arg_is_empty = "Argument can not be empty.";
     public:
         using trim_policy_type = TrimPolicy;
@@ -1289,9 +2972,11 @@ namespace csv_co {
         explicit reader(std::filesystem::path const & csv_src) : src {mio::ro_mmap {}} {
             auto const str = csv_src.string();
             if (str.find(".gz") != std::string::npos)
-                src = EzGz::IGzFile<>(str).readAll();
+                open_stream(std::make_unique<detail::gz_stream>(str));
             else if (str.find(".bz2") != std::string::npos)
-                src = bz2_connector::read_all(str.c_str());
+                open_stream(std::make_unique<detail::bz2_stream>(str));
+            else if (str.find(".zst") != std::string::npos)
+                open_stream(detail::zst_source(str));
             else {
                 std::error_code mmap_error;
                 std::get<0>(src).map(str.c_str(), mmap_error);
@@ -1337,7 +3022,7 @@ namespace csv_co {
         // TODO: is const?
         /// Columns getter
         template <std::size_t ParseChunkSize=default_chunk_size>
-        [[nodiscard]] auto cols() noexcept (max_field_size_no_trace) -> std::size_t {
+        [[nodiscard]] auto cols() -> std::size_t {
             if constexpr (!max_field_size_no_trace && empty_rows_ignore)
                 return cols_impl<ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>();
             else if constexpr (max_field_size_no_trace && empty_rows_ignore)
@@ -1350,8 +3035,10 @@ namespace csv_co {
 
         /// Rows getter
         template <std::size_t ParseChunkSize=default_chunk_size>
-        [[nodiscard]] auto rows() noexcept -> std::size_t requires (std::is_same_v<EmptyRows, ER::std_4180>) {
-            if constexpr (!max_field_size_no_trace && empty_rows_ignore)
+        [[nodiscard]] auto rows() -> std::size_t requires (std::is_same_v<EmptyRows, ER::std_4180>) {
+            if constexpr (max_field_size_no_trace)
+                return count_rows_impl(1);
+            else if constexpr (!max_field_size_no_trace && empty_rows_ignore)
                 return rows_impl<ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>();
             else if constexpr (max_field_size_no_trace && empty_rows_ignore)
                 return rows_impl<ParseChunkSize, empty_t, ignore_empty_rows_tracer>();
@@ -1361,6 +3048,13 @@ namespace csv_co {
                 return rows_impl<ParseChunkSize, empty_t>();
         }
 
+        /// Rows getter counting on several threads (0 - as many as the hardware runs concurrently)
+        template <typename Mode>
+        [[nodiscard]] auto rows(unsigned threads = 0) -> std::size_t
+            requires (std::is_same_v<Mode, parallel> && max_field_size_no_trace && std::is_same_v<EmptyRows, ER::std_4180>) {
+            return count_rows_impl(threads ? threads : std::max(1u, std::thread::hardware_concurrency()));
+        }
+
         /// Executes CSV-stream validation;)
         template <std::size_t ParseChunkSize=default_chunk_size>
         [[nodiscard]] auto validate() -> reader& {
@@ -1379,6 +3073,13 @@ namespace csv_co {
 #endif
         }
 
+        /// Executes CSV-stream validation on several threads (0 - as many as the hardware runs concurrently)
+        template <typename Mode, std::size_t ParseChunkSize=default_chunk_size>
+        [[nodiscard]] auto validate(unsigned threads = 0) -> reader&
+            requires (std::is_same_v<Mode, parallel> && max_field_size_no_trace && !empty_rows_ignore) {
+            return validate_parallel_impl<ParseChunkSize>(threads);
+        }
+
         /// Validated rows getter
         [[nodiscard]] auto validated_rows() const -> std::size_t {
             if (validated_shape.has_value())
@@ -1395,20 +3096,18 @@ namespace csv_co {
                 throw exception ("There are no ready cols. Call validate() method first.");
         }
 
-        /// Executes span iteration mode
-        template <std::size_t ParseChunkSize=default_chunk_size>
-        void run_spans(value_field_span_cb_t v, new_row_cb_t n=[]{}) {
-            vfs_cb = std::move(v);
-            new_row_cb = std::move(n);
-
+        /// Executes span iteration mode. Callbacks are any callables, they are inlined into the parsing loop.
+        template <std::size_t ParseChunkSize=default_chunk_size, typename V, typename N = no_callback>
+        void run_spans(V && v, N && n = {}) requires (field_span_callback<V> && new_row_callback<N>) {
+            no_callback h;
             if constexpr (!max_field_size_no_trace && empty_rows_ignore)
-                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,ignore_empty_rows_tracer>();
+                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,ignore_empty_rows_tracer>(h, v, n);
             else if constexpr (max_field_size_no_trace && empty_rows_ignore)
-                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, empty_t,ignore_empty_rows_tracer>();
+                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, empty_t,ignore_empty_rows_tracer>(h, v, n);
             else if constexpr (!max_field_size_no_trace && !empty_rows_ignore)
-                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,empty_t>();
+                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,empty_t>(h, v, n);
             else
-                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, empty_t>();
+                run_spans_impl<v_field_span_caller_tag, ParseChunkSize, empty_t>(h, v, n);
 #if 0
             run_spans_impl<v_field_span_caller_tag, ParseChunkSize
                 , my_conditional2<!max_field_size_no_trace, max_field_size_tracer, empty_t>::type>();
@@ -1416,60 +3115,142 @@ namespace csv_co {
         }
 
         /// Executes Spanning mode (overload)
-        template <std::size_t ParseChunkSize=default_chunk_size>
-        void run_spans(header_field_span_cb_t h, value_field_span_cb_t v, new_row_cb_t n=[]{}) {
-            hfs_cb = std::move(h);
-            vfs_cb = std::move(v);
-            new_row_cb = std::move(n);
+        template <std::size_t ParseChunkSize=default_chunk_size, typename H, typename V, typename N = no_callback>
+        void run_spans(H && h, V && v, N && n = {}) requires (field_span_callback<H> && field_span_callback<V> && new_row_callback<N>) {
             if constexpr (!max_field_size_no_trace && empty_rows_ignore)
-                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,ignore_empty_rows_tracer>();
+                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,ignore_empty_rows_tracer>(h, v, n);
             else if constexpr (max_field_size_no_trace && empty_rows_ignore)
-                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, empty_t,ignore_empty_rows_tracer>();
+                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, empty_t,ignore_empty_rows_tracer>(h, v, n);
             else if constexpr (!max_field_size_no_trace && !empty_rows_ignore)
-                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,empty_t>();
+                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, max_field_size_tracer,empty_t>(h, v, n);
+            else
+                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, empty_t>(h, v, n);
+        }
+
+        /// Executes span iteration mode unescaping the fields in place: v gets the unquoted and trimmed value of every field
+        /// as a view into the source, so no field takes an allocation. The source is rewritten as it is parsed (a file is
+        /// mapped privately for that, the file itself is intact), thus it is read once: the reader has nothing left to read.
+        template <std::size_t ParseChunkSize=default_chunk_size, typename V, typename N = no_callback>
+        void run_unescaped(V && v, N && n = {}) requires (std::invocable<V &, std::string_view> && new_row_callback<N>) {
+            make_source_writable();
+            auto unescaped = [&v](cell_span & span) { v(unescape(span)); };
+            if constexpr (std::is_same_v<std::decay_t<N>, no_callback>)
+                run_spans<ParseChunkSize>(unescaped);
             else
-                run_spans_impl<hv_field_span_caller_tag, ParseChunkSize, empty_t>();
+                run_spans<ParseChunkSize>(unescaped, n);
+            // A streamed archive is decompressed anew by the next run, the windows unescaped are gone
+            if (windows)
+                return;
+            std::visit([&](auto const & r) noexcept { src_offset = r.size(); }, src);
+            validated_shape = std::nullopt;
         }
 
         /// Executes row iteration mode
-        template <std::size_t ParseChunkSize=default_chunk_size>
-        void run_rows(value_row_span_cb_t v) {
-            vrs_cb = std::move(v);
+        template <std::size_t ParseChunkSize=default_chunk_size, typename V>
+        void run_rows(V && v) requires row_span_callback<V> {
+            no_callback h;
             if constexpr (!max_field_size_no_trace && empty_rows_ignore)
-                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>(cols<ParseChunkSize>());
+                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>(cols<ParseChunkSize>(), h, v);
             else if constexpr (max_field_size_no_trace && empty_rows_ignore)
-                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, empty_t, ignore_empty_rows_tracer>(cols<ParseChunkSize>());
+                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, empty_t, ignore_empty_rows_tracer>(cols<ParseChunkSize>(), h, v);
             else if constexpr (!max_field_size_no_trace && !empty_rows_ignore)
-                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, empty_t>(cols<ParseChunkSize>());
+                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, empty_t>(cols<ParseChunkSize>(), h, v);
             else
-                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, empty_t>(cols<ParseChunkSize>());
+                run_rows_impl<v_row_span_caller_tag, ParseChunkSize, empty_t>(cols<ParseChunkSize>(), h, v);
         }
 
         //Executes Row iteration mode (overload)
-        template <std::size_t ParseChunkSize=default_chunk_size>
-        void run_rows(header_row_span_cb_t h, value_row_span_cb_t v) {
-            hrs_cb = std::move(h);
-            vrs_cb = std::move(v);
+        template <std::size_t ParseChunkSize=default_chunk_size, typename H, typename V>
+        void run_rows(H && h, V && v) requires (row_span_callback<H> && row_span_callback<V>) {
             if constexpr (!max_field_size_no_trace && empty_rows_ignore)
-                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>(cols<ParseChunkSize>());
+                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>(cols<ParseChunkSize>(), h, v);
             else if constexpr (max_field_size_no_trace && empty_rows_ignore)
-                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, empty_t, ignore_empty_rows_tracer>(cols<ParseChunkSize>());
+                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, empty_t, ignore_empty_rows_tracer>(cols<ParseChunkSize>(), h, v);
             else if constexpr (!max_field_size_no_trace && !empty_rows_ignore)
-                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, empty_t>(cols<ParseChunkSize>());
+                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, max_field_size_tracer, empty_t>(cols<ParseChunkSize>(), h, v);
             else
-                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, empty_t>(cols<ParseChunkSize>());
+                run_rows_impl<hv_row_span_caller_tag, ParseChunkSize, empty_t>(cols<ParseChunkSize>(), h, v);
+        }
+
+        /// Executes row iteration mode on several threads (0 - as many as the hardware runs concurrently).
+        /// Value rows are handed to the callback from the worker threads, concurrently and in no particular order,
+        /// unless delivery::ordered is asked for: then the calling thread gets them in the file order.
+        template <std::size_t ParseChunkSize=default_chunk_size, typename V>
+        void run_rows_parallel(unsigned threads, V && v, delivery d = delivery::unordered)
+            requires (max_field_size_no_trace && !empty_rows_ignore && row_span_callback<V>) {
+            no_callback h, n;
+            run_parallel_impl<v_row_span_caller_tag, ParseChunkSize>(threads, d, h, v, n);
+        }
+
+        /// Executes row iteration mode on several threads (overload). The header row is handed over first.
+        template <std::size_t ParseChunkSize=default_chunk_size, typename H, typename V>
+        void run_rows_parallel(unsigned threads, H && h, V && v, delivery d = delivery::unordered)
+            requires (max_field_size_no_trace && !empty_rows_ignore && row_span_callback<H> && row_span_callback<V>) {
+            no_callback n;
+            run_parallel_impl<hv_row_span_caller_tag, ParseChunkSize>(threads, d, h, v, n);
+        }
+
+        /// Executes span iteration mode on several threads, see run_rows_parallel()
+        template <std::size_t ParseChunkSize=default_chunk_size, typename V, typename N = no_callback>
+        void run_spans_parallel(unsigned threads, V && v, N && n = {}, delivery d = delivery::unordered)
+            requires (max_field_size_no_trace && !empty_rows_ignore && field_span_callback<V> && new_row_callback<N>) {
+            no_callback h;
+            run_parallel_impl<v_field_span_caller_tag, ParseChunkSize>(threads, d, h, v, n);
+        }
+
+        /// Executes span iteration mode on several threads (overload). The header fields are handed over first.
+        template <std::size_t ParseChunkSize=default_chunk_size, typename H, typename V, typename N = no_callback>
+        void run_spans_parallel(unsigned threads, H && h, V && v, N && n = {}, delivery d = delivery::unordered)
+            requires (max_field_size_no_trace && !empty_rows_ignore && field_span_callback<H> && field_span_callback<V> && new_row_callback<N>) {
+            run_parallel_impl<hv_field_span_caller_tag, ParseChunkSize>(threads, d, h, v, n);
         }
 
         template <std::size_t ParseChunkSize = default_chunk_size>
         auto skip_rows(std::size_t rows_to_skip) -> reader& {
-            if constexpr (!max_field_size_no_trace && empty_rows_ignore)
-                src_offset = rows_to_skip ? skip_rows_impl<ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>(rows_to_skip, get_start_offset()) : 0;
-            else if constexpr (max_field_size_no_trace && empty_rows_ignore)
-                src_offset = rows_to_skip ? skip_rows_impl<ParseChunkSize, empty_t,ignore_empty_rows_tracer>(rows_to_skip, get_start_offset()) : 0;
-            else if constexpr (!max_field_size_no_trace && !empty_rows_ignore)
-                src_offset = rows_to_skip ? skip_rows_impl<ParseChunkSize, max_field_size_tracer, empty_t>(rows_to_skip, get_start_offset()) : 0;
-            else 
-                src_offset = rows_to_skip ? skip_rows_impl<ParseChunkSize, empty_t>(rows_to_skip, get_start_offset()) : 0;
+            auto const skip = [&] {
+                if constexpr (!max_field_size_no_trace && empty_rows_ignore)
+                    return skip_rows_impl<ParseChunkSize, max_field_size_tracer, ignore_empty_rows_tracer>(rows_to_skip, get_start_offset());
+                else if constexpr (max_field_size_no_trace && empty_rows_ignore)
+                    return skip_rows_impl<ParseChunkSize, empty_t,ignore_empty_rows_tracer>(rows_to_skip, get_start_offset());
+                else if constexpr (!max_field_size_no_trace && !empty_rows_ignore)
+                    return skip_rows_impl<ParseChunkSize, max_field_size_tracer, empty_t>(rows_to_skip, get_start_offset());
+                else
+                    return skip_rows_impl<ParseChunkSize, empty_t>(rows_to_skip, get_start_offset());
+            };
+            if (!windows) {
+                src_offset = rows_to_skip ? skip() : 0;
+                return *this;
+            }
+            if (!rows_to_skip) {
+                start_window = 0;
+                src_offset = 0;
+                to_first_window();
+                return *this;
+            }
+            // rows of a streamed archive are skipped from where its rows start, window after window, until the count
+            // runs out
+            to_first_window();
+            auto & window = std::get<std::vector<char>>(src);
+            while (rows_to_skip) {
+                auto const offset = skip();
+                if (!rows_to_skip && offset < window.size()) {
+                    src_offset = offset;
+                    break;
+                }
+                if (!windows->next(window)) {
+                    // not as many rows as that: nothing is skipped, as with sources in memory
+                    if (rows_to_skip) {
+                        start_window = 0;
+                        src_offset = 0;
+                        to_first_window();
+                    } else
+                        src_offset = window.size();
+                    break;
+                }
+                // the window is skipped as a whole
+                start_window = windows->index();
+                src_offset = 0;
+            }
             return *this;
         }
 
@@ -1528,6 +3309,92 @@ namespace csv_co {
             return c;
         }
 
+        /// Handle of a named header column: rs[r.column("State")] costs what rs[index] does.
+        /// The header row is indexed on the first call, unless the header row iteration has done it already.
+        template <std::size_t ParseChunkSize=default_chunk_size>
+        column_handle column(std::string_view name) {
+            if (header_names.empty())
+                index_header(header<std::vector<cell_span>, ParseChunkSize>());
+            auto const index = header_names.find(name);
+            if (index == detail::name_index::npos)
+                throw exception("No such column: ", name);
+            return {index};
+        }
+
+        /// Casts the cells of a column to T in bulk, on every value row, marking the ones that fail instead of throwing.
+        /// The first row is taken for the header unless has_header is false.
+        template <typename T, std::size_t ParseChunkSize=default_chunk_size>
+        column_cast<T> try_column_as(column_handle column, bool has_header = true) requires std::is_arithmetic_v<T> {
+            column_cast<T> c;
+            auto const rows = value_rows_hint(has_header);
+            c.values.reserve(rows);
+            c.failures.reserve((rows + 63) / 64);
+            run_value_rows<ParseChunkSize>(has_header, [&c, column](row_span & rs) {
+                check_column(rs, column);
+                auto const row = c.values.size();
+                if (row % 64 == 0)
+                    c.failures.push_back(0);
+                auto const r = rs[column].template try_as<T>();
+                c.values.push_back(r.value);
+                if (!r) {
+                    c.failures.back() |= std::uint64_t(1) << (row % 64);
+                    ++c.failed;
+                }
+            });
+            return c;
+        }
+
+        /// Casts the cells of a column (by index or by name) to T in bulk, see above
+        template <typename T, std::size_t ParseChunkSize=default_chunk_size>
+        column_cast<T> try_column_as(std::size_t column, bool has_header = true) requires std::is_arithmetic_v<T> {
+            return try_column_as<T, ParseChunkSize>(column_handle{column}, has_header);
+        }
+        template <typename T, std::size_t ParseChunkSize=default_chunk_size>
+        column_cast<T> try_column_as(std::string_view name) requires std::is_arithmetic_v<T> {
+            return try_column_as<T, ParseChunkSize>(column<ParseChunkSize>(name));
+        }
+
+        /// Casts the cells of a column to T, on every value row, into a contiguous vector. Throws as as<T>() does.
+        /// The first row is taken for the header unless has_header is false.
+        template <typename T, std::size_t ParseChunkSize=default_chunk_size>
+        std::vector<T> column_as(column_handle column, bool has_header = true) requires std::is_arithmetic_v<T> {
+            std::vector<T> values;
+            values.reserve(value_rows_hint(has_header));
+            run_value_rows<ParseChunkSize>(has_header, [&values, column](row_span & rs) {
+                check_column(rs, column);
+                values.push_back(rs[column].template as<T>());
+            });
+            return values;
+        }
+
+        /// Casts the cells of a column (by index or by name) to T into a contiguous vector, see above
+        template <typename T, std::size_t ParseChunkSize=default_chunk_size>
+        std::vector<T> column_as(std::size_t column, bool has_header = true) requires std::is_arithmetic_v<T> {
+            return column_as<T, ParseChunkSize>(column_handle{column}, has_header);
+        }
+        template <typename T, std::size_t ParseChunkSize=default_chunk_size>
+        std::vector<T> column_as(std::string_view name) requires std::is_arithmetic_v<T> {
+            return column_as<T, ParseChunkSize>(column<ParseChunkSize>(name));
+        }
+
+        /// Casts several columns (handles, indexes or names) of the header-led table at once, in a single pass:
+        /// auto [lat, pop] = r.columns_as<float, long>("Latitude", "Population");
+        template <typename ... Ts, typename ... Columns>
+        std::tuple<std::vector<Ts>...> columns_as(Columns const & ... columns)
+            requires (sizeof...(Ts) == sizeof...(Columns) && (std::is_arithmetic_v<Ts> && ...)) {
+            std::array<column_handle, sizeof...(Columns)> const handles {to_column(columns)...};
+            auto const last = std::max_element(handles.begin(), handles.end(), [](auto l, auto r) { return l.index < r.index; });
+            std::tuple<std::vector<Ts>...> values;
+            std::apply([rows = value_rows_hint(true)](auto & ... v) { (v.reserve(rows), ...); }, values);
+            run_value_rows<default_chunk_size>(true, [&values, &handles, last = *last](row_span & rs) {
+                check_column(rs, last);
+                [&]<std::size_t ... I>(std::index_sequence<I...>) {
+                    (std::get<I>(values).push_back(rs[handles[I]].template as<Ts>()), ...);
+                }(std::index_sequence_for<Ts...>{});
+            });
+            return values;
+        }
+
         /// Seek to the beginning
         template <std::size_t ParseChunkSize=default_chunk_size>
         void seek() requires (std::is_same_v<EmptyRows, ER::std_4180>) {
@@ -1753,9 +3620,9 @@ namespace csv_co {
         static_assert(sizeof(cell_span) == 16);
     }; //reader<>
 
-    template <TrimPolicyConcept T, QuoteConcept Q, DelimiterConcept D, LineBreakConcept L, MaxFieldSizePolicyConcept M, EmptyRowsPolicyConcept E>
+    template <TrimPolicyConcept T, QuoteConcept Q, DelimiterConcept D, LineBreakConcept L, MaxFieldSizePolicyConcept M, EmptyRowsPolicyConcept E, ParseEnginePolicyConcept P>
     template<typename T1, typename G, class ... Bases>
-    void reader<T, Q, D, L, M, E>::promise_type_base<T1, G, Bases...>::
+    void reader<T, Q, D, L, M, E, P>::promise_type_base<T1, G, Bases...>::
     unhandled_exception() {
         std::terminate();
     }
@@ -0,0 +1,262 @@
+///
+/// \file   include/csv_co/simd.hpp
+/// \author wiluite
+/// \brief  Vectorized byte classification kernels for CSV_co parsers.
+///
+/// Kernels are built for every instruction set of the target architecture (scalar, SSE2, AVX2, AVX-512BW on x86-64)
+/// regardless of compiler options, and the best one the running CPU supports is selected once, at first use.
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+    #define CSV_CO_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#else
+    #define CSV_CO_SIMD_X86 0
+#endif
+
+#if defined(_MSC_VER)
+    #define CSV_CO_ALWAYS_INLINE __forceinline
+#else
+    #define CSV_CO_ALWAYS_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace csv_co::simd {
+
+    /// Number of bytes classified at once
+    constexpr std::size_t block_size = 64;
+
+    /// Instruction sets the kernels are built for
+    enum class isa {
+        scalar = 0,
+        sse2,
+        avx2,
+        avx512
+    };
+
+    /// What a parallel parser needs to know about a range before the quote state at its beginning is known
+    struct range_summary {
+        /// First line break standing outside of quotes, if the range begins outside [0] or inside [1] of quotes
+        char const * first_break[2] {nullptr, nullptr};
+        /// Odd number of quotes: the quote state at the end of the range is the opposite of the one at its beginning
+        bool odd_quotes = false;
+    };
+
+    /// Line breaks standing outside of quotes in a range, counted for both quote states it can begin in
+    struct break_count {
+        /// If the range begins outside [0] or inside [1] of quotes
+        std::size_t breaks[2] {0, 0};
+        /// Odd number of quotes: the quote state at the end of the range is the opposite of the one at its beginning
+        bool odd_quotes = false;
+    };
+}
+
+#define CSV_CO_SIMD_NS scalar
+#define CSV_CO_SIMD_LEVEL 0
+#include "simd_kernels.hpp"
+#undef CSV_CO_SIMD_NS
+#undef CSV_CO_SIMD_LEVEL
+
+#if CSV_CO_SIMD_X86
+    // SSE2 is the x86-64 baseline
+    #define CSV_CO_SIMD_NS sse2
+    #define CSV_CO_SIMD_LEVEL 1
+    #include "simd_kernels.hpp"
+    #undef CSV_CO_SIMD_NS
+    #undef CSV_CO_SIMD_LEVEL
+
+    #if defined(__clang__)
+        #pragma clang attribute push (__attribute__((target("avx2,bmi,bmi2,popcnt,pclmul"))), apply_to = function)
+    #elif defined(__GNUC__)
+        #pragma GCC push_options
+        #pragma GCC target("avx2,bmi,bmi2,popcnt,pclmul")
+    #endif
+    #define CSV_CO_SIMD_NS avx2
+    #define CSV_CO_SIMD_LEVEL 2
+    #include "simd_kernels.hpp"
+    #undef CSV_CO_SIMD_NS
+    #undef CSV_CO_SIMD_LEVEL
+    #if defined(__clang__)
+        #pragma clang attribute pop
+    #elif defined(__GNUC__)
+        #pragma GCC pop_options
+    #endif
+
+    #if defined(__clang__)
+        #pragma clang attribute push (__attribute__((target("avx512f,avx512bw,avx2,bmi,bmi2,popcnt,pclmul"))), apply_to = function)
+    #elif defined(__GNUC__)
+        #pragma GCC push_options
+        #pragma GCC target("avx512f,avx512bw,avx2,bmi,bmi2,popcnt,pclmul")
+    #endif
+    #define CSV_CO_SIMD_NS avx512
+    #define CSV_CO_SIMD_LEVEL 3
+    #include "simd_kernels.hpp"
+    #undef CSV_CO_SIMD_NS
+    #undef CSV_CO_SIMD_LEVEL
+    #if defined(__clang__)
+        #pragma clang attribute pop
+    #elif defined(__GNUC__)
+        #pragma GCC pop_options
+    #endif
+#endif
+
+namespace csv_co::simd {
+
+    /// Best instruction set of the running CPU (and OS) that the kernels are built for
+    inline isa detect() noexcept {
+#if CSV_CO_SIMD_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuid(r, 0);
+        auto const max_leaf = r[0];
+        __cpuid(r, 1);
+        bool const popcnt = r[2] & (1 << 23), pclmul = r[2] & (1 << 1), osxsave = r[2] & (1 << 27);
+        if (max_leaf < 7 || !osxsave || !popcnt || !pclmul)
+            return isa::sse2;
+        auto const xcr0 = _xgetbv(0);
+        __cpuidex(r, 7, 0);
+        bool const avx2 = (r[1] & (1 << 5)) && (r[1] & (1 << 3)) && (r[1] & (1 << 8)) && (xcr0 & 0x6) == 0x6;
+        bool const avx512 = avx2 && (r[1] & (1 << 16)) && (r[1] & (1 << 30)) && (xcr0 & 0xe6) == 0xe6;
+    #else
+        __builtin_cpu_init();
+        bool const avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")
+            && __builtin_cpu_supports("popcnt") && __builtin_cpu_supports("pclmul");
+        bool const avx512 = avx2 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    #endif
+        return avx512 ? isa::avx512 : avx2 ? isa::avx2 : isa::sse2;
+#else
+        return isa::scalar;
+#endif
+    }
+
+    /// Instruction set of the kernels in use
+    inline isa selected_isa() noexcept {
+        static isa const chosen = detect();
+        return chosen;
+    }
+
+    /// Name of an instruction set
+    constexpr char const * isa_name(isa i) noexcept {
+        switch (i) {
+            case isa::sse2: return "sse2";
+            case isa::avx2: return "avx2";
+            case isa::avx512: return "avx512";
+            default: return "scalar";
+        }
+    }
+
+    namespace detail {
+        /// Kernel built for the selected instruction set
+        template <typename F>
+        inline F pick([[maybe_unused]] F scalar_kernel, [[maybe_unused]] F sse2_kernel, [[maybe_unused]] F avx2_kernel
+                      , [[maybe_unused]] F avx512_kernel) noexcept {
+            switch (selected_isa()) {
+                case isa::avx512: return avx512_kernel;
+                case isa::avx2: return avx2_kernel;
+                case isa::sse2: return sse2_kernel;
+                default: return scalar_kernel;
+            }
+        }
+    }
+
+#if CSV_CO_SIMD_X86
+    #define CSV_CO_SIMD_DISPATCH(F, ...) detail::pick<F>(&scalar::__VA_ARGS__, &sse2::__VA_ARGS__, &avx2::__VA_ARGS__, &avx512::__VA_ARGS__)
+#else
+    #define CSV_CO_SIMD_DISPATCH(F, ...) static_cast<F>(&scalar::__VA_ARGS__)
+#endif
+
+    /// Kernel that classifies n bytes at p (64 at most) into a bitmask where bit i is set if byte i equals any of Chars
+    template <char ... Chars>
+    inline auto eq_mask_kernel() noexcept {
+        using kernel_type = std::uint64_t (*)(char const *, std::size_t) noexcept;
+        static kernel_type const kernel = CSV_CO_SIMD_DISPATCH(kernel_type, eq_mask<Chars...>);
+        return kernel;
+    }
+
+    /// Stage 1 of the two-stage parsing. Writes one word per 64-byte block of [b, e) to out, where a bit is set for each of
+    /// Chars standing outside of Quote-enclosed text. in_quotes carries the quote state between calls: all ones inside quotes.
+    template <char Quote, char ... Chars>
+    inline void index_unquoted(char const * b, char const * e, std::uint64_t * out, std::uint64_t & in_quotes) noexcept {
+        using kernel_type = void (*)(char const *, char const *, std::uint64_t *, std::uint64_t &) noexcept;
+        static kernel_type const kernel = CSV_CO_SIMD_DISPATCH(kernel_type, index_unquoted<Quote, Chars...>);
+        kernel(b, e, out, in_quotes);
+    }
+
+    /// Stage 1 of the two-stage parsing for quote-free text: one word per 64-byte block of [b, e), a bit is set for each of Chars
+    template <char ... Chars>
+    inline void index(char const * b, char const * e, std::uint64_t * out) noexcept {
+        using kernel_type = void (*)(char const *, char const *, std::uint64_t *) noexcept;
+        static kernel_type const kernel = CSV_CO_SIMD_DISPATCH(kernel_type, index<Chars...>);
+        kernel(b, e, out);
+    }
+
+    /// Summarizes [b, e) speculatively, for both quote states it can begin in, in one pass. No quotes unless Quoting.
+    template <char Quote, char LineBreak, bool Quoting = true>
+    inline range_summary summarize(char const * b, char const * e) noexcept {
+        using kernel_type = range_summary (*)(char const *, char const *) noexcept;
+        static kernel_type const kernel = CSV_CO_SIMD_DISPATCH(kernel_type, summarize<Quote, LineBreak, Quoting>);
+        return kernel(b, e);
+    }
+
+    /// Counts line breaks of [b, e) speculatively, for both quote states it can begin in, in one pass. No quotes unless Quoting.
+    template <char Quote, char LineBreak, bool Quoting = true>
+    inline break_count count_breaks(char const * b, char const * e) noexcept {
+        using kernel_type = break_count (*)(char const *, char const *) noexcept;
+        static kernel_type const kernel = CSV_CO_SIMD_DISPATCH(kernel_type, count_breaks<Quote, LineBreak, Quoting>);
+        return kernel(b, e);
+    }
+
+#undef CSV_CO_SIMD_DISPATCH
+
+    /// Finds the nearest of Chars in a contiguous range, classifying one 64-byte block at a time.
+    /// The mask of the current block is cached, so that walking from one found character to the next one
+    /// costs a shift and a "count trailing zeros".
+    template <char ... Chars>
+    class scanner {
+        decltype(eq_mask_kernel<Chars...>()) kernel = eq_mask_kernel<Chars...>();
+        char const * base = nullptr;
+        char const * end = nullptr;
+        std::uint64_t mask = 0;
+
+        void load(char const * p) noexcept {
+            base = p;
+            mask = kernel(p, static_cast<std::size_t>(end - p));
+        }
+
+    public:
+        /// Starts scanning of a new range
+        void reset(char const * b, char const * e) noexcept {
+            end = e;
+            if (b != e)
+                load(b);
+            else
+                base = b, mask = 0;
+        }
+
+        /// Returns the position of the first of Chars in [p, end), or end. Positions must not decrease.
+        CSV_CO_ALWAYS_INLINE char const * next(char const * p) noexcept {
+            // Short fields are typical, so look at the nearest byte before touching the block mask
+            if (p < end && ((*p == Chars) || ...))
+                return p;
+            while (p < end) {
+                if (auto const off = static_cast<std::size_t>(p - base); off < block_size) {
+                    if (auto const m = mask >> off)
+                        return p + std::countr_zero(m);
+                    p = base + block_size;
+                    if (p >= end)
+                        break;
+                }
+                load(p);
+            }
+            return end;
+        }
+    };
+}
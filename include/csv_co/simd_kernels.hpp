@@ -0,0 +1,139 @@
+///
+/// \file   include/csv_co/simd_kernels.hpp
+/// \author wiluite
+/// \brief  Byte classification kernels of one instruction set.
+///
+/// Included by simd.hpp once per instruction set, so there is no include guard. The including side defines
+/// CSV_CO_SIMD_NS (the namespace to put the kernels in) and CSV_CO_SIMD_LEVEL (0 - scalar, 1 - SSE2, 2 - AVX2,
+/// 3 - AVX-512BW), and compiles this file with the matching target options.
+
+namespace csv_co::simd::CSV_CO_SIMD_NS {
+
+#if CSV_CO_SIMD_LEVEL == 2
+    template <char ... Chars>
+    inline std::uint64_t classify(__m256i const v) noexcept {
+        auto r = _mm256_setzero_si256();
+        ((r = _mm256_or_si256(r, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(Chars)))), ...);
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(r));
+    }
+#elif CSV_CO_SIMD_LEVEL == 1
+    template <char ... Chars>
+    inline std::uint64_t classify(__m128i const v) noexcept {
+        auto r = _mm_setzero_si128();
+        ((r = _mm_or_si128(r, _mm_cmpeq_epi8(v, _mm_set1_epi8(Chars)))), ...);
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(r));
+    }
+#endif
+
+    /// Returns a bitmask of the 64-byte block where bit i is set if byte i equals any of Chars
+    template <char ... Chars>
+    inline std::uint64_t eq_mask(char const * p) noexcept {
+#if CSV_CO_SIMD_LEVEL == 3
+        auto const v = _mm512_loadu_si512(reinterpret_cast<void const *>(p));
+        __mmask64 r = 0;
+        ((r |= _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(Chars))), ...);
+        return static_cast<std::uint64_t>(r);
+#elif CSV_CO_SIMD_LEVEL == 2
+        return classify<Chars...>(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)))
+            | (classify<Chars...>(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(p + 32))) << 32);
+#elif CSV_CO_SIMD_LEVEL == 1
+        return classify<Chars...>(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)))
+            | (classify<Chars...>(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 16))) << 16)
+            | (classify<Chars...>(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 32))) << 32)
+            | (classify<Chars...>(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p + 48))) << 48);
+#else
+        std::uint64_t r = 0;
+        for (std::size_t i = 0; i != block_size; ++i)
+            r |= static_cast<std::uint64_t>(((p[i] == Chars) || ...)) << i;
+        return r;
+#endif
+    }
+
+    /// Partial block variant: classifies n < 64 bytes without touching memory past p + n
+    template <char ... Chars>
+    inline std::uint64_t eq_mask(char const * p, std::size_t n) noexcept {
+        if (n >= block_size)
+            return eq_mask<Chars...>(p);
+        alignas(block_size) char buf[block_size] {};
+        std::memcpy(buf, p, n);
+        return eq_mask<Chars...>(buf) & ((std::uint64_t{1} << n) - 1);
+    }
+
+    /// Bit i of the result is the XOR of bits 0..i of the argument: set inside quotes, given quote positions
+    inline std::uint64_t prefix_xor(std::uint64_t bits) noexcept {
+#if CSV_CO_SIMD_LEVEL >= 2
+        // carry-less multiplication by all ones
+        auto const r = _mm_clmulepi64_si128(_mm_set_epi64x(0, static_cast<long long>(bits)), _mm_set1_epi8('\xff'), 0);
+        return static_cast<std::uint64_t>(_mm_cvtsi128_si64(r));
+#else
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+#endif
+    }
+
+    /// Stage 1 of the two-stage parsing. Writes one word per 64-byte block of [b, e) to out, where a bit is set for each of
+    /// Chars standing outside of Quote-enclosed text. in_quotes carries the quote state between calls: all ones inside quotes.
+    template <char Quote, char ... Chars>
+    inline void index_unquoted(char const * b, char const * e, std::uint64_t * out, std::uint64_t & in_quotes) noexcept {
+        for (; b < e; b += block_size) {
+            auto const n = static_cast<std::size_t>(e - b);
+            auto const quotes = eq_mask<Quote>(b, n);
+            auto const structurals = eq_mask<Chars...>(b, n);
+            auto const inside = prefix_xor(quotes) ^ in_quotes;
+            in_quotes = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+            *out++ = structurals & ~inside;
+        }
+    }
+
+    /// Stage 1 of the two-stage parsing for quote-free text: one word per 64-byte block of [b, e), a bit is set for each of Chars
+    template <char ... Chars>
+    inline void index(char const * b, char const * e, std::uint64_t * out) noexcept {
+        for (; b < e; b += block_size)
+            *out++ = eq_mask<Chars...>(b, static_cast<std::size_t>(e - b));
+    }
+
+    /// Summarizes [b, e) speculatively, for both quote states it can begin in, in one pass. No quotes unless Quoting.
+    template <char Quote, char LineBreak, bool Quoting>
+    inline range_summary summarize(char const * b, char const * e) noexcept {
+        range_summary r;
+        std::uint64_t in_quotes = 0;
+        for (; b < e; b += block_size) {
+            auto const n = static_cast<std::size_t>(e - b);
+            auto const quotes = Quoting ? eq_mask<Quote>(b, n) : std::uint64_t{0};
+            if (!r.first_break[0] || !r.first_break[1]) {
+                auto const breaks = eq_mask<LineBreak>(b, n);
+                auto const inside = prefix_xor(quotes) ^ in_quotes;
+                if (auto const m = breaks & ~inside; m && !r.first_break[0])
+                    r.first_break[0] = b + std::countr_zero(m);
+                if (auto const m = breaks & inside; m && !r.first_break[1])
+                    r.first_break[1] = b + std::countr_zero(m);
+            }
+            in_quotes ^= std::uint64_t{0} - static_cast<std::uint64_t>(std::popcount(quotes) & 1);
+        }
+        r.odd_quotes = in_quotes != 0;
+        return r;
+    }
+
+    /// Counts line breaks of [b, e) speculatively, for both quote states it can begin in, in one pass. No quotes unless Quoting.
+    template <char Quote, char LineBreak, bool Quoting>
+    inline break_count count_breaks(char const * b, char const * e) noexcept {
+        break_count r;
+        std::uint64_t in_quotes = 0;
+        for (; b < e; b += block_size) {
+            auto const n = static_cast<std::size_t>(e - b);
+            auto const quotes = Quoting ? eq_mask<Quote>(b, n) : std::uint64_t{0};
+            auto const breaks = eq_mask<LineBreak>(b, n);
+            auto const inside = quotes ? prefix_xor(quotes) ^ in_quotes : in_quotes;
+            in_quotes = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+            r.breaks[0] += static_cast<std::size_t>(std::popcount(breaks & ~inside));
+            r.breaks[1] += static_cast<std::size_t>(std::popcount(breaks & inside));
+        }
+        r.odd_quotes = in_quotes != 0;
+        return r;
+    }
+}
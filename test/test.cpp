@@ -6,7 +6,35 @@
 #define BOOST_UT_DISABLE_MODULE
 #include "ut.hpp"
 #include <csv_co/reader.hpp>
+#include <bzip2/bzlib.h>
+#include <bit>
 #include <fstream>
+#include <random>
+#include <cstdlib>
+
+namespace {
+    /// Heap allocations made by this thread, to see what parsing allocates
+    thread_local std::size_t heap_allocations = 0;
+}
+
+void * operator new(std::size_t size) {
+    ++heap_allocations;
+    if (auto p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc {};
+}
+
+// the replacements are seen inlined into new-expressions
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void * p) noexcept { std::free(p); }
+
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
 
 int main() {
 
@@ -1338,6 +1366,14 @@ int main() {
         expect(v[1]=="222");
         expect(v[2]=="333");
 
+        // skips add up, skipping no rows goes back to the beginning
+        std::string rest;
+        reader_type r ("a\nb\nc\nd\n");
+        r.skip_rows(1).skip_rows(1).run_rows([&rest](auto & rs) { rest += rs[0].operator cell_string(); });
+        expect(rest == "cd");
+        rest.clear();
+        r.skip_rows(0).skip_rows(3).run_rows([&rest](auto & rs) { rest += rs[0].operator cell_string(); });
+        expect(rest == "d");
     };
 
     "ignore empty rows"_test = [] {
@@ -1431,5 +1467,1075 @@ int main() {
         }
     };
 
-}
 
+    // -- Topic change: Vectorized scanning --
+
+    "long fields crossing scanner blocks and parse chunks"_test = [] {
+
+        std::string const plain (150, 'x');
+        std::string const quoted = '"' + std::string(70, 'y') + ",\n\"\"" + std::string(70, 'z') + '"';
+        std::string const csv = plain + ',' + quoted + ",1\n" + "2," + quoted + ',' + plain;
+
+        auto collect = [&csv] (auto & r) {
+            std::vector<cell_string> v;
+            r.run_spans([&v](auto & s) { v.emplace_back(s.operator unquoted_cell_string()); });
+            return v;
+        };
+
+        std::vector<cell_string> const expected {plain, std::string(70, 'y') + ",\n\"" + std::string(70, 'z'), "1"
+            , "2", std::string(70, 'y') + ",\n\"" + std::string(70, 'z'), plain};
+
+        reader r(csv);
+        expect(collect(r) == expected);
+        expect(r.rows<1>() == 2 && r.rows<13>() == 2 && r.rows<64>() == 2 && r.rows<65>() == 2 && r.rows() == 2);
+        expect(r.cols<1>() == 3 && r.cols<63>() == 3 && r.cols() == 3);
+        expect(nothrow([&r] { [[maybe_unused]] auto & _ = r.validate<7>(); }));
+        expect(r.validated_rows() == 2 && r.validated_cols() == 3);
+
+        std::vector<cell_string> v;
+        r.run_spans<1>([&v](auto & s) { v.emplace_back(s.operator unquoted_cell_string()); });
+        expect(v == expected);
+    };
+
+    "max field size and empty rows policies see every skipped byte"_test = [] {
+
+        using reader_type = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::trace<100>>;
+        {
+            auto fired = 0u;
+            reader_type r (std::string(100, 'a') + ",\"" + std::string(98, 'b') + "\"\n");
+            r.install_notification_handler([&fired](auto) { ++fired; });
+            r.run_spans([](auto) {});
+            expect(fired == 0);
+        }
+        {
+            auto fired = 0u;
+            reader_type r (std::string(101, 'a') + ",b\n");
+            r.install_notification_handler([&fired](auto) { ++fired; });
+            r.run_spans<17>([](auto) {});
+            expect(fired == 1);
+        }
+
+        using er_reader_type = reader<trim_policy::alltrim, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::no_trace, ER::ignore>;
+        std::string const plain (80, 'c');
+        for (auto const & [csv, expected_rows] : {std::pair{plain + "\r\n\r\n" + plain + "\r\n", 2u}
+                                                 , std::pair{plain + "\n\n\n" + plain + '\n', 2u}
+                                                 , std::pair{plain + "\r \r\n\n" + plain + '\n', 3u}}) {
+            auto rows = 0u;
+            er_reader_type(csv).run_spans([](auto) {}, [&rows] { ++rows; });
+            expect(rows == expected_rows);
+        }
+    };
+
+
+    "parse engines agree"_test = [] {
+
+        auto trace = [] <typename Engine, typename MaxFieldSize, typename EmptyRows, std::size_t ChunkSize> (std::string const & csv) {
+            using reader_type = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MaxFieldSize, EmptyRows, Engine>;
+            std::string result;
+            auto fired = 0u;
+            auto make = [&] {
+                reader_type r (csv);
+                r.install_notification_handler([&fired](auto) { ++fired; });
+                return r;
+            };
+            make().template run_spans<ChunkSize>([&](auto & s) { result += '[' + s.raw_string() + ']'; }, [&] { result += '\n'; });
+            result += std::to_string(make().template cols<ChunkSize>());
+            try {
+                auto r = make();
+                result += std::to_string(r.template validate<ChunkSize>().validated_rows());
+            } catch (typename reader_type::exception const & e) {
+                result += e.what();
+            }
+            if constexpr (std::is_same_v<EmptyRows, ER::std_4180>) {
+                result += std::to_string(make().template rows<ChunkSize>());
+                try {
+                    make().template run_rows<ChunkSize>([&](auto & rs) { result += std::to_string(rs.size()); });
+                } catch (typename reader_type::exception const & e) {
+                    result += e.what();
+                }
+            }
+            result += std::to_string(make().template skip_rows<ChunkSize>(1).size());
+            return result + '/' + std::to_string(fired);
+        };
+
+        std::mt19937 gen (2024);
+        std::string const tokens[] = {"a", "bcd", ",", ",", "\"", "\"", "\n", "\r\n", " ", std::string(70, 'x')};
+        for (auto i = 0; i != 300; ++i) {
+            std::string csv;
+            for (auto n = 1 + gen() % 60; n; --n)
+                csv += tokens[gen() % std::size(tokens)];
+
+            expect(trace.operator()<engine::state_machine, MFS::no_trace, ER::std_4180, 1>(csv)
+                == trace.operator()<engine::structural_index, MFS::no_trace, ER::std_4180, 1>(csv));
+            expect(trace.operator()<engine::state_machine, MFS::no_trace, ER::std_4180, 64>(csv)
+                == trace.operator()<engine::structural_index, MFS::no_trace, ER::std_4180, 64>(csv));
+            expect(trace.operator()<engine::state_machine, MFS::trace<4>, ER::std_4180, 5>(csv)
+                == trace.operator()<engine::structural_index, MFS::trace<4>, ER::std_4180, 5>(csv));
+            expect(trace.operator()<engine::direct, MFS::no_trace, ER::std_4180, 1>(csv)
+                == trace.operator()<engine::structural_index, MFS::no_trace, ER::std_4180, 1>(csv));
+            expect(trace.operator()<engine::direct, MFS::trace<4>, ER::std_4180, 5>(csv)
+                == trace.operator()<engine::structural_index, MFS::trace<4>, ER::std_4180, 5>(csv));
+
+            // the empty rows policy expects line breaks of one kind and no line breaks within quotes
+            std::erase_if(csv, [](char c) { return c == '\r' || c == '"'; });
+            if (csv.empty())
+                continue;
+            expect(trace.operator()<engine::state_machine, MFS::trace<3>, ER::ignore, 3>(csv)
+                == trace.operator()<engine::structural_index, MFS::trace<3>, ER::ignore, 3>(csv));
+            expect(trace.operator()<engine::direct, MFS::trace<3>, ER::ignore, 3>(csv)
+                == trace.operator()<engine::structural_index, MFS::trace<3>, ER::ignore, 3>(csv));
+        }
+    };
+
+    // -- Topic change: Callbacks --
+
+    "callbacks are any callables, copyable or not"_test = [] {
+
+        struct field_counter {
+            std::vector<cell_string> fields;
+            field_counter() = default;
+            field_counter(field_counter const &) = delete;
+            void operator()(reader<>::cell_span & span) { fields.emplace_back(span.raw_string()); }
+        };
+
+        reader r ("a,b\n1,2\n3,4");
+        for (auto chunk_test : {false, true}) {
+            field_counter h, v;
+            auto rows = 0u;
+            if (chunk_test)
+                r.run_spans<1>(h, v, [&rows] { ++rows; });
+            else
+                r.run_spans(h, v, [&rows] { ++rows; });
+            expect(h.fields == std::vector<cell_string>{"a", "b"});
+            expect(v.fields == std::vector<cell_string>{"1", "2", "3", "4"});
+            expect(rows == 3);
+        }
+
+        field_counter all;
+        r.run_spans(all);
+        std::function<void(reader<>::cell_span &)> f = [&all] (auto & span) { all(span); };
+        r.run_spans(f);
+        expect(all.fields.size() == 12);
+
+        auto header_rows = 0u, value_rows = 0u;
+        auto const count_values = [&value_rows] (auto &) { ++value_rows; };
+        r.run_rows<2>([&header_rows] (auto & rs) { header_rows += rs.size() == 2 && rs[0] == "a"; }, count_values);
+        r.run_rows(count_values);
+        expect(header_rows == 1 && value_rows == 5);
+    };
+
+    // -- Topic change: Rows assembly --
+
+    "rows carried over chunks of any size come out whole"_test = [] {
+
+        std::mt19937 gen (11);
+        std::string const fields[] = {"", "a", "bcd", "\"x,\ny\"", std::string(150, 'w')};
+        for (auto cols : {1u, 3u, 40u}) {
+            std::string csv;
+            for (auto row = 0; row != 120; ++row)
+                for (auto col = 0u; col != cols; ++col)
+                    csv += fields[gen() % std::size(fields)] + (col + 1 == cols ? '\n' : ',');
+
+            std::vector<std::vector<cell_string>> expected (1);
+            reader r (csv);
+            r.run_spans([&](auto & s) { expected.back().emplace_back(s.raw_string()); }, [&] { expected.emplace_back(); });
+            expected.pop_back();
+
+            auto rows_of = [&r] <std::size_t ChunkSize> {
+                std::vector<std::vector<cell_string>> rows;
+                r.run_rows<ChunkSize>([&](auto & rs) {
+                    rows.emplace_back();
+                    for (auto & e : rs)
+                        rows.back().emplace_back(e.raw_string());
+                });
+                return rows;
+            };
+            expect(rows_of.operator()<1>() == expected);
+            expect(rows_of.operator()<7>() == expected);
+            expect(rows_of.operator()<64>() == expected);
+            expect(rows_of.operator()<4096>() == expected);
+        }
+    };
+
+    // -- Topic change: Header names --
+
+    "perfect hash of header names"_test = [] {
+
+        for (auto n : {0u, 1u, 2u, 7u, 3000u}) {
+            std::vector<cell_string> names;
+            for (auto i = 0u; i != n; ++i)
+                names.emplace_back("col" + std::to_string(i * 7919 % 100003));
+            csv_co::detail::name_index index;
+            index.assign(names);
+            auto found = 0u;
+            for (auto i = 0u; i != n; ++i)
+                found += index.find(names[i]) == i;
+            expect(found == n);
+            expect(index.find("col") == csv_co::detail::name_index::npos);
+            expect(index.find("") == csv_co::detail::name_index::npos);
+        }
+
+        csv_co::detail::name_index index;
+        index.assign({"a", "b", "a", ""});
+        expect(index.find("a") == 2 && index.find("b") == 1 && index.find("") == 3);
+    };
+
+    "columns by name and by handle, per reader"_test = [] {
+
+        using reader_type = reader<trim_policy::alltrim>;
+        reader_type r1 ("State, Population\nCA,10\nNY,20\n");
+        reader_type r2 ("Population,Latitude, State\n5,33.5,CA\n");
+
+        auto const state = r1.column("State");
+        auto const population = r1.column("Population");
+        expect(state.index == 0 && population.index == 1);
+        expect(r2.column("State").index == 2);
+        expect(throws<reader_type::exception>([&r1] { [[maybe_unused]] auto _ = r1.column("Latitude"); }));
+
+        auto sum = 0u;
+        r1.run_rows([](auto &) {}, [&](auto & rs) {
+            if (rs[state] == "CA" || rs["State"] == "NY")
+                sum += rs[population].template as<unsigned>() + rs["Population"].template as<unsigned>();
+        });
+        expect(sum == 60);
+
+        // the header of one reader does not change the names of another one
+        r2.run_rows([](auto &) {}, [&](auto & rs) {
+            expect(rs["State"] == "CA" && rs["Latitude"].template as<double>() == 33.5);
+        });
+        r1.skip_rows(1).run_rows([&](auto & rs) { sum += rs[population].template as<unsigned>(); });
+        expect(sum == 90);
+    };
+
+    // -- Topic change: Parallel iteration --
+
+    "parallel iteration modes deliver what the serial ones do"_test = [] {
+
+        std::mt19937 gen (3);
+        std::string const fields[] = {"a", "bc", "", "\"x,\ny\"", "\"\"\"q\n\"", "\"\n\n\"", std::string(90, 'z')};
+        std::string csv;
+        for (auto row = 0; row != 500; ++row)
+            for (auto col = 0; col != 3; ++col)
+                csv += fields[gen() % std::size(fields)] + (col == 2 ? '\n' : ',');
+
+        for (auto const & src : {csv, csv.substr(0, csv.size() - 1)}) {
+            std::vector<std::string> serial_rows, serial_spans;
+            reader(src).run_rows([&](auto & rs) {
+                serial_rows.emplace_back();
+                for (auto & e : rs)
+                    serial_rows.back() += e.raw_string() + '|';
+            });
+            reader(src).run_spans([&](auto & s) { serial_spans.emplace_back(s.raw_string()); }, [&] { serial_spans.emplace_back("\n"); });
+
+            for (auto threads : {1u, 2u, 3u, 7u, 64u}) {
+                std::mutex m;
+                std::vector<std::string> rows, spans;
+                reader r (src);
+                r.run_rows_parallel<64>(threads, [&](auto & rs) {
+                    std::string row;
+                    for (auto & e : rs)
+                        row += e.raw_string() + '|';
+                    std::lock_guard lock (m);
+                    rows.emplace_back(row);
+                });
+                std::sort(rows.begin(), rows.end());
+                auto sorted_rows = serial_rows;
+                std::sort(sorted_rows.begin(), sorted_rows.end());
+                expect(rows == sorted_rows);
+
+                rows.clear();
+                r.run_rows_parallel<64>(threads, [&](auto & rs) {
+                    rows.emplace_back();
+                    for (auto & e : rs)
+                        rows.back() += e.raw_string() + '|';
+                }, reader<>::delivery::ordered);
+                expect(rows == serial_rows);
+
+                r.run_spans_parallel<100>(threads, [&](auto & s) { spans.emplace_back(s.raw_string()); }
+                    , [&] { spans.emplace_back("\n"); }, reader<>::delivery::ordered);
+                expect(spans == serial_spans);
+
+                std::string header;
+                rows.clear();
+                r.run_rows_parallel(threads, [&](auto & rs) { header = rs[0].raw_string(); }
+                    , [&](auto & rs) { rows.emplace_back(); for (auto & e : rs) rows.back() += e.raw_string() + '|'; }
+                    , reader<>::delivery::ordered);
+                expect(header + '|' == serial_rows[0].substr(0, serial_rows[0].find('|') + 1));
+                expect(std::equal(rows.begin(), rows.end(), serial_rows.begin() + 1, serial_rows.end()));
+            }
+        }
+
+        auto throwing = [&csv] (reader<>::delivery d) {
+            reader<>(csv).run_rows_parallel<64>(4, [](auto &) { throw std::logic_error("stop"); }, d);
+        };
+        expect(throws<std::logic_error>([&] { throwing(reader<>::delivery::unordered); }));
+        expect(throws<std::logic_error>([&] { throwing(reader<>::delivery::ordered); }));
+    };
+
+    "parallel validation makes the serial shape and messages"_test = [] {
+
+        std::mt19937 gen (4);
+        std::string const fields[] = {"a", "", "\"x,\ny\"", "\"\"\"q\n\"", std::string(70, 'z')};
+        auto outcome = [] (reader<> & r, auto validate) -> std::string {
+            try {
+                validate(r);
+                return std::to_string(r.validated_rows()) + 'x' + std::to_string(r.validated_cols());
+            } catch (reader<>::exception const & e) {
+                return e.what();
+            }
+        };
+        for (auto i = 0; i != 40; ++i) {
+            std::string csv;
+            for (auto row = 0; row != 200; ++row) {
+                auto const cols = (gen() % 50) ? 3 : 1 + gen() % 5;
+                for (auto col = 0u; col != cols; ++col)
+                    csv += fields[gen() % std::size(fields)] + (col + 1 == cols ? '\n' : ',');
+            }
+            if (i & 1)
+                csv.pop_back();
+
+            reader<> serial (csv);
+            auto const expected = outcome(serial, [](auto & r) { [[maybe_unused]] auto & _ = r.validate(); });
+            for (auto threads : {1u, 2u, 5u, 16u}) {
+                reader<> r (csv);
+                expect(outcome(r, [threads](auto & r) { [[maybe_unused]] auto & _ = r.template validate<parallel, 64>(threads); }) == expected);
+            }
+        }
+
+        reader r (std::filesystem::path("game.csv"));
+        expect(nothrow([&r] { [[maybe_unused]] auto & _ = r.validate<parallel>(); }));
+        expect(r.validated_rows() == 14 && r.validated_cols() == 6);
+        reader invalid (std::filesystem::path("game-invalid-format.csv"));
+        std::string serial_message, parallel_message;
+        try { [[maybe_unused]] auto & _ = reader(std::filesystem::path("game-invalid-format.csv")).validate(); }
+        catch (reader<>::exception const & e) { serial_message = e.what(); }
+        try { [[maybe_unused]] auto & _ = invalid.validate<parallel>(3); }
+        catch (reader<>::exception const & e) { parallel_message = e.what(); }
+        expect(!serial_message.empty() && serial_message == parallel_message);
+    };
+
+    "counted rows match parsed rows"_test = [] {
+
+        using parsing_reader = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::trace<1u << 30>>;
+        std::mt19937 gen (5);
+        std::string const tokens[] = {"a", ",", "\"", "\n", "\n\n", "\r\n", std::string(70, 'x'), std::string(130, '\n')};
+        for (auto i = 0; i != 300; ++i) {
+            std::string csv;
+            for (auto n = 1 + gen() % 80; n; --n)
+                csv += tokens[gen() % std::size(tokens)];
+
+            auto const expected = parsing_reader(csv).rows();
+            reader<> r (csv);
+            expect(r.rows() == expected);
+            for (auto threads : {2u, 3u, 8u})
+                expect(r.rows<parallel>(threads) == expected);
+            expect(r.skip_rows(1).rows() == parsing_reader(csv).skip_rows(1).rows());
+        }
+    };
+
+    // -- Topic change: Quote-free parsing --
+
+    "no_quotes policy keeps quote characters as field contents"_test = [] {
+
+        std::string const csv = "a,\"b,c\"\n\"\"\"d\",e,f\n";
+        std::vector<cell_string> const expected {"a", "\"b", "c\"", "\"\"\"d\"", "e", "f"};
+
+        auto check = [&] <typename Engine> {
+            using reader_type = reader<trim_policy::no_trimming, no_quotes, comma_delimiter, non_mac_ln_brk, MFS::no_trace, ER::std_4180, Engine>;
+            std::vector<cell_string> v;
+            reader_type r (csv);
+            r.run_spans([&v](auto & s) { v.emplace_back(s.operator unquoted_cell_string()); });
+            expect(v == expected);
+            expect(r.rows() == 2 && r.cols() == 3 && r.template rows<parallel>(4) == 2);
+            expect(nothrow([&r] { [[maybe_unused]] auto & _ = r.validate(); }));
+            expect(r.validated_rows() == 2 && r.validated_cols() == 3);
+            v.clear();
+            r.run_rows_parallel(3, [&v](auto & rs) { for (auto & e : rs) v.emplace_back(e.raw_string()); }, reader_type::delivery::ordered);
+            expect(v == expected);
+        };
+        check.operator()<engine::structural_index>();
+        check.operator()<engine::state_machine>();
+        check.operator()<engine::direct>();
+    };
+
+    "quote-free chunks next to quoted ones"_test = [] {
+
+        std::string const plain (200, 'p');
+        std::string const csv = plain + ',' + plain + "\n\"q,\n" + plain + "\",1\n" + plain + ",2";
+        std::vector<cell_string> const expected {plain, plain, "q,\n" + plain, "1", plain, "2"};
+        for (auto check : {+[](reader<> & r) { std::vector<cell_string> v; r.run_spans<64>([&v](auto & s) { v.emplace_back(s.operator unquoted_cell_string()); }); return v; }
+                         , +[](reader<> & r) { std::vector<cell_string> v; r.run_spans<100>([&v](auto & s) { v.emplace_back(s.operator unquoted_cell_string()); }); return v; }
+                         , +[](reader<> & r) { std::vector<cell_string> v; r.run_spans<1>([&v](auto & s) { v.emplace_back(s.operator unquoted_cell_string()); }); return v; }}) {
+            reader r (csv);
+            expect(check(r) == expected);
+        }
+    };
+
+    // -- Topic change: Coroutine frames --
+
+    "parsing allocates no coroutine frames in steady state"_test = [] {
+
+        std::string csv;
+        for (auto row = 0; row != 300; ++row)
+            csv += "a,\"b,\nc\"," + std::to_string(row) + '\n';
+
+        // allocations of the second of two same calls
+        auto steady = [](auto && f) {
+            f();
+            auto const before = heap_allocations;
+            f();
+            return heap_allocations - before;
+        };
+
+        auto allocations = [&] <typename Engine> {
+            using reader_type = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::no_trace, ER::std_4180, Engine>;
+            reader_type r (csv);
+            return std::vector<std::size_t> {
+                steady([&r] { [[maybe_unused]] auto _ = r.template cols<64>(); })
+                , steady([&r] { [[maybe_unused]] auto _ = r.template skip_rows<64>(1).size(); })
+                , steady([&r] { [[maybe_unused]] auto & _ = r.template validate<64>(); })
+                , steady([&r] { r.template run_spans<64>([](auto &) {}); })
+                , steady([&r] { r.template run_rows<64>([](auto &) {}, [](auto &) {}); })
+            };
+        };
+
+        // no frames in the direct engine: what it allocates is what the tracers allocate
+        auto const direct = allocations.operator()<engine::direct>();
+        expect(direct[0] == 0 && direct[1] == 0);
+        expect(allocations.operator()<engine::structural_index>() == direct);
+        expect(allocations.operator()<engine::state_machine>() == direct);
+    };
+
+    // -- Topic change: Runtime CPU dispatch --
+
+    "kernels of every supported instruction set agree with scalar ones"_test = [] {
+
+        using namespace csv_co::simd;
+        expect(selected_isa() == detect());
+        expect(std::string(isa_name(selected_isa())) != "");
+#if CSV_CO_SIMD_X86
+        expect(selected_isa() >= isa::sse2);
+#endif
+        std::mt19937 gen (7);
+        std::string const alphabet = "ab,\"\n";
+        for (auto i = 0; i != 200; ++i) {
+            std::string text (gen() % 300, ' ');
+            for (auto & c : text)
+                c = alphabet[gen() % alphabet.size()];
+            auto const b = text.data(), e = text.data() + text.size();
+
+            auto trace = [&] (auto index_unquoted, auto index, auto summarize, auto count_breaks) {
+                std::vector<std::uint64_t> words ((text.size() + block_size - 1) / block_size);
+                std::string result;
+                std::uint64_t in_quotes = 0;
+                index_unquoted(b, e, words.data(), in_quotes);
+                for (auto w : words) result += std::to_string(w) + ' ';
+                index(b, e, words.data());
+                for (auto w : words) result += std::to_string(w) + ' ';
+                auto const s = summarize(b, e);
+                auto const c = count_breaks(b, e);
+                return result + std::to_string(in_quotes) + std::to_string(s.first_break[0] ? s.first_break[0] - b : -1)
+                    + std::to_string(s.first_break[1] ? s.first_break[1] - b : -1) + std::to_string(s.odd_quotes)
+                    + std::to_string(c.breaks[0]) + ',' + std::to_string(c.breaks[1]) + std::to_string(c.odd_quotes);
+            };
+#define CSV_CO_TRACE_KERNELS(ns) trace(ns::index_unquoted<'"', ',', '\n'>, ns::index<',', '\n'>, ns::summarize<'"', '\n', true>, ns::count_breaks<'"', '\n', true>)
+            auto const expected = CSV_CO_TRACE_KERNELS(scalar);
+            expect(trace(index_unquoted<'"', ',', '\n'>, index<',', '\n'>, summarize<'"', '\n'>, count_breaks<'"', '\n'>) == expected);
+#if CSV_CO_SIMD_X86
+            expect(CSV_CO_TRACE_KERNELS(sse2) == expected);
+            if (selected_isa() >= isa::avx2)
+                expect(CSV_CO_TRACE_KERNELS(avx2) == expected);
+            if (selected_isa() >= isa::avx512)
+                expect(CSV_CO_TRACE_KERNELS(avx512) == expected);
+#endif
+#undef CSV_CO_TRACE_KERNELS
+        }
+    };
+
+    // -- Topic change: Cell accessors --
+
+    "cell accessors work in place and agree with the unquoted string"_test = [] {
+
+        auto check = [] <TrimPolicyConcept Trim> (Trim) {
+            using cell_span = typename reader<Trim>::cell_span;
+            // what the conversion to unquoted_cell_string always did
+            auto expected = [](std::string s) {
+                using namespace csv_co::string_functions;
+                if (s.find('"') != std::string::npos) {
+                    unquote(s, '"');
+                    unique_quote(s, '"');
+                }
+                return Trim::ret_trim(cell_string{s});
+            };
+            std::mt19937 gen (13);
+            std::string const alphabet = "ab\" \t\r\n";
+            for (auto i = 0; i != 3000; ++i) {
+                std::string text (gen() % 9, ' ');
+                for (auto & c : text)
+                    c = alphabet[gen() % alphabet.size()];
+                cell_span const span {text};
+                auto const value = expected(text);
+                expect(cell_string(span.operator unquoted_cell_string()) == value);
+                expect(span.size() == value.size());
+                expect(span.empty() == value.empty());
+                expect(span == value);
+                expect(!(span == value + "a"));
+                if (!value.empty())
+                    expect(!(span == std::string_view(value).substr(1)));
+                if (auto const view = span.unquoted_view())
+                    expect(*view == value && (view->empty() || (view->data() >= text.data() && view->data() < text.data() + text.size())));
+            }
+        };
+        check(trim_policy::no_trimming{});
+        check(trim_policy::alltrim{});
+
+        // only collapsing an escaped quote needs memory
+        std::string const plain = R"( "CA" )", escaped = R"("C""A")";
+        reader<trim_policy::alltrim>::cell_span const p {plain}, q {escaped};
+        auto const before = heap_allocations;
+        expect(p == "CA" && p.size() == 2 && !p.empty() && p.unquoted_view() == "CA");
+        expect(q == R"(C"A)" && q.size() == 3 && !q.unquoted_view());
+        expect(heap_allocations == before);
+        expect(cell_string(q.operator unquoted_cell_string()) == R"(C"A)");
+    };
+
+    "numeric casts parse in place"_test = [] {
+
+        std::string const fields[] = {R"( "42" )", R"(" -7")", "3.25", R"( "1e3"  )", R"("0.5""")"};
+        reader<trim_policy::alltrim>::cell_span const i {fields[0]}, n {fields[1]}, f {fields[2]}, e {fields[3]}, odd {fields[4]};
+        auto const before = heap_allocations;
+        expect(i.as<int>() == 42 && i.as<unsigned char>() == 42 && n.as<long long>() == -7);
+        expect(f.as<float>() == 3.25f && f.as<double>() == 3.25 && f.as<long double>() == 3.25L);
+        expect(e.as<double>() == 1000.0 && e.as<long double>() == 1000.0L);
+        expect(heap_allocations == before);
+        // an escaped quote to collapse: parsed from the unquoted copy, as before
+        expect(odd.as<double>() == 0.5);
+        expect(throws<reader<trim_policy::alltrim>::exception>([&] { [[maybe_unused]] auto _ = n.as<unsigned>(); }));
+    };
+
+    // -- Topic change: Number parsing --
+
+    "integers are parsed as std::from_chars parses them"_test = [] {
+
+        auto agree = [] <typename T> (std::string const & text, T) {
+            T expected = 42, got = 42;
+            auto const e = std::from_chars(text.data(), text.data() + text.size(), expected);
+            auto const g = csv_co::numbers::parse_integer(text.data(), text.data() + text.size(), got);
+            return e.ec == g.ec && e.ptr == g.ptr && expected == got;
+        };
+        auto agree_all = [&](std::string const & text) {
+            return agree(text, int{}) && agree(text, unsigned{}) && agree(text, std::int8_t{}) && agree(text, std::uint16_t{})
+                && agree(text, long{}) && agree(text, 0ull) && agree(text, 0ll) && agree(text, char{});
+        };
+
+        for (auto const text : {"", "-", "+1", "0", "-0", "7", "12a", "a12", "-12 ", "00000000000000000000000000123", "4294967295"
+                , "4294967296", "-2147483648", "-2147483649", "18446744073709551615", "18446744073709551616", "99999999999999999999"
+                , "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809", "123456789012345678901234"
+                , "12345678", "123456789", "1234567890123456", "12345678901234567", "1234567890123456789", "12345678:", "1234567/"})
+            expect(agree_all(text)) << text;
+
+        std::mt19937_64 gen (11);
+        std::string const alphabet = "0123456789-x";
+        for (auto i = 0; i != 20000; ++i) {
+            std::string text (gen() % 24, '0');
+            for (auto & c : text)
+                c = alphabet[gen() % (i % 2 ? 10 : alphabet.size())];
+            expect(agree_all(text)) << text;
+            auto const n = gen() >> (gen() % 64);
+            expect(agree_all(std::to_string(n)) && agree_all('-' + std::to_string(n)));
+        }
+    };
+
+#ifndef _MSC_VER
+    "long doubles are parsed as strtold parses them"_test = [] {
+
+        auto agree = [](std::string const & text) {
+            char * end;
+            errno = 0;
+            auto const expected = std::strtold(text.c_str(), &end);
+            auto const range_error = errno == ERANGE;
+            long double got = 42;
+            auto const r = csv_co::numbers::parse_long_double(text.data(), text.data() + text.size(), got);
+            if (end == text.c_str())
+                return r.ec == std::errc::invalid_argument && got == 42;
+            if (range_error)
+                return r.ec == std::errc::result_out_of_range;
+            return r.ec == std::errc() && r.ptr == text.data() + (end - text.c_str())
+                && (got == expected || (std::isnan(got) && std::isnan(expected))) && std::signbit(got) == std::signbit(expected);
+        };
+
+        for (auto const text : {"", " ", "+", "-", "+-1", "-+1", "++1", ".", "-.", "e5", "1e", "1e+", "1.e3", ".5", "-.5e-3", " \t+42.5x"
+                , "0", "-0", "0.000", "00012.3400", "1e27", "1e28", "1e-27", "1e-28", "123456789012345678", "18446744073709551615"
+                , "18446744073709551616", "0.1", "0.3", "2.2250738585072014e-308", "1.18973149535723176502e+4932", "1.18974e+4932"
+                , "3.6451995318824746025e-4951", "1e-5000", "0e99999999999", "12345678901234567890123456789e-20", "0x1p3", "-0X1.8P1"
+                , "inf", "-INFINITY", "nan", "NaN(123)", "infinite", "4.9406564584124654e-324", "1,5"})
+            expect(agree(text)) << text;
+
+        // longer than the stack buffer of the C library fallbacks
+        for (auto const & text : {std::string(200, '7') + "e-150", "-0." + std::string(300, '0') + "12e300", "0x" + std::string(150, 'f') + "p-500"
+                , "nan(" + std::string(200, 'a') + ")", std::string(126, '1'), std::string(127, '1') + 'e' + std::string(120, '0') + '1'})
+            expect(agree(text)) << text;
+
+        std::mt19937_64 gen (17);
+        for (auto i = 0; i != 20000; ++i) {
+            std::string text = gen() % 4 ? "" : "-";
+            auto const digits = 1 + gen() % (i % 3 ? 19 : 40);
+            auto const point = gen() % (digits + 1);
+            for (std::size_t d = 0; d != digits; ++d) {
+                if (d == point && d)
+                    text += '.';
+                text += static_cast<char>('0' + gen() % 10);
+            }
+            if (gen() % 2)
+                text += 'e' + std::to_string(static_cast<int>(gen() % (i % 5 ? 60 : 10000)) - (i % 5 ? 30 : 5000));
+            expect(agree(text)) << text;
+        }
+
+        // stale errno of someone else isn't taken for a range error
+        errno = ERANGE;
+        std::string const field = "12.5";
+        expect(reader<>::cell_span(field).as<long double>() == 12.5L);
+    };
+#endif
+
+    "casts of dirty data report errors by code"_test = [] {
+
+        std::string const fields[] = {"  ", R"( "17" )", "abc", "300", "-1.5e3", R"("1e99999")"};
+        using cell_span = reader<trim_policy::alltrim>::cell_span;
+        auto const before = heap_allocations;
+        auto const empty = cell_span{fields[0]}.try_as<int>();
+        auto const ok = cell_span{fields[1]}.try_as<int>();
+        auto const nan = cell_span{fields[2]}.try_as<double>();
+        auto const big = cell_span{fields[3]}.try_as<std::uint8_t>();
+        auto const real = cell_span{fields[4]}.try_as<long double>();
+        auto const inf = cell_span{fields[5]}.try_as<double>();
+        expect(heap_allocations == before);
+        expect(!empty && empty.ec == std::errc::invalid_argument && *empty == 0);
+        expect(ok && *ok == 17);
+        expect(!nan && nan.ec == std::errc::invalid_argument);
+        expect(!big && big.ec == std::errc::result_out_of_range && *big == 0);
+        expect(real && *real == -1500.0L);
+        expect(!inf && inf.ec == std::errc::result_out_of_range);
+
+        using reader_type = reader<trim_policy::alltrim>;
+        std::string const csv = "id,price\n1,10.5\n2,n/a\n3,\n4, 7 \n";
+        reader_type r (csv);
+        auto const prices = r.validate().try_column_as<double>(r.column("price"));
+        expect(prices.values == std::vector<double>{10.5, 0, 0, 7});
+        expect(prices.failed == 2 && prices.failures == std::vector<std::uint64_t>{0b0110});
+        expect(!prices.failed_at(0) && prices.failed_at(1) && prices.failed_at(2) && !prices.failed_at(3));
+
+        // no header, more rows than a mask word holds
+        std::string many;
+        for (auto i = 0; i != 130; ++i)
+            many += (i % 7 ? std::to_string(i) : "x") + '\n';
+        reader_type m (many);
+        auto const ids = m.try_column_as<int>(0, false);
+        expect(ids.values.size() == 130 && ids.failures.size() == 3 && ids.failed == 19);
+        for (auto i = 0u; i != 130; ++i)
+            expect(ids.failed_at(i) == !(i % 7) && ids.values[i] == (i % 7 ? int(i) : 0));
+        expect(throws<reader_type::exception>([&] { [[maybe_unused]] auto _ = m.try_column_as<int>(1, false); }));
+    };
+
+    "columns cast into contiguous vectors"_test = [] {
+
+        using reader_type = reader<trim_policy::alltrim>;
+        std::string const csv = "City, Lat ,Population\nA,34.5,100\nB,\"33.25\",2500\nC,-1e1, 7\n";
+        reader_type r (csv);
+        expect(r.column_as<long>("Population") == std::vector<long>{100, 2500, 7});
+        expect(r.validate().column_as<float>(1) == std::vector<float>{34.5f, 33.25f, -10.f});
+        expect(r.column_as<int>(r.column("Population")) == std::vector<int>{100, 2500, 7});
+
+        auto const [population, latitude] = r.columns_as<unsigned, double>("Population", r.column("Lat"));
+        expect(population == std::vector<unsigned>{100, 2500, 7} && latitude == std::vector<double>{34.5, 33.25, -10});
+        auto const [lat, pop, lat2] = r.columns_as<float, std::size_t, long double>(1, "Population", 1u);
+        expect(lat.size() == 3 && pop[1] == 2500 && lat2[2] == -10.0L);
+
+        // the header isn't data here
+        reader_type numbers ("1,2\n3,4\n");
+        expect(numbers.column_as<int>(1, false) == std::vector<int>{2, 4});
+
+        // bad cells throw as as<T>() does, missing columns throw
+        expect(throws<reader_type::exception>([&] { [[maybe_unused]] auto _ = r.column_as<int>(0); }));
+        expect(throws<reader_type::exception>([&] { [[maybe_unused]] auto _ = r.column_as<int>(3); }));
+        expect(throws<reader_type::exception>([&] { [[maybe_unused]] auto _ = r.columns_as<int, int>(2, "Nope"); }));
+    };
+
+    // -- Topic change: Trim policies --
+
+    "view trim policies trim without copying and agree with string trim policies"_test = [] {
+
+        // the same trimming of dashes and spaces, told by views and by the original string interface
+        struct view_dashes {
+            static std::string_view trim(std::string_view v) noexcept {
+                while (!v.empty() && (v.front() == '-' || v.front() == ' '))
+                    v.remove_prefix(1);
+                while (!v.empty() && (v.back() == '-' || v.back() == ' '))
+                    v.remove_suffix(1);
+                return v;
+            }
+        };
+        struct string_dashes {
+            static cell_string ret_trim(cell_string s) {
+                s.erase(0, s.find_first_not_of("- "));
+                s.erase(s.find_last_not_of("- ") + 1);
+                return s;
+            }
+            static unquoted_cell_string ret_trim(unquoted_cell_string s) {
+                s.erase(0, s.find_first_not_of("- "));
+                s.erase(s.find_last_not_of("- ") + 1);
+                return s;
+            }
+        };
+        static_assert(TrimPolicyConcept<view_dashes> && TrimPolicyConcept<string_dashes>);
+        static_assert(ViewTrimPolicyConcept<trim_policy::alltrim> && StringTrimPolicyConcept<trim_policy::alltrim>);
+
+        std::mt19937 gen (19);
+        std::string const alphabet = "a-\" \n";
+        for (auto i = 0; i != 3000; ++i) {
+            std::string text (gen() % 9, ' ');
+            for (auto & c : text)
+                c = alphabet[gen() % alphabet.size()];
+            typename reader<view_dashes>::cell_span const v {text};
+            typename reader<string_dashes>::cell_span const s {text};
+            auto const value = cell_string(s.operator unquoted_cell_string());
+            expect(cell_string(v.operator unquoted_cell_string()) == value);
+            expect(v.operator cell_string() == s.operator cell_string());
+            expect(v.trimmed_view() == s.operator cell_string());
+            expect(v == value && v.size() == value.size() && v.empty() == value.empty());
+            if (auto const view = v.unquoted_view())
+                expect(*view == value);
+        }
+
+        std::string const quoted = R"("-7-")", padded = "  3.5--";
+        reader<view_dashes>::cell_span const q {quoted}, p {padded};
+        auto const before = heap_allocations;
+        expect(q.unquoted_view() == "7" && q == "7" && q.as<int>() == 7);
+        expect(p.trimmed_view() == "3.5" && p.as<double>() == 3.5);
+        expect(heap_allocations == before);
+
+        reader<view_dashes> r ("- 1-,\"-2-\"\n3--, 4\n");
+        auto sum {0};
+        r.run_spans([&](auto s) { sum += s.template as<int>(); });
+        expect(sum == 10);
+    };
+
+    // -- Topic change: In-place unescaping --
+
+    "fields unescaped in place are the unquoted strings"_test = [] {
+
+        auto check = [] <typename Engine, std::size_t ChunkSize> (std::string const & csv) {
+            using reader_type = reader<trim_policy::alltrim, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::no_trace, ER::std_4180, Engine>;
+            std::string expected, unescaped;
+            reader_type (csv).template run_spans<ChunkSize>([&](auto & s) { expected += '[' + s.operator unquoted_cell_string() + ']'; }, [&] { expected += '\n'; });
+            reader_type r (csv);
+            r.template run_unescaped<ChunkSize>([&](std::string_view v) {
+                expect(v.empty() || (v.data() >= r.data() && v.data() + v.size() <= r.data() + csv.size()));
+                (unescaped += '[') += v;
+                unescaped += ']';
+            }, [&] { unescaped += '\n'; });
+            expect(unescaped == expected);
+            // nothing is left to read
+            auto cells {0};
+            r.run_spans([&](auto &) { ++cells; });
+            expect(cells == 0);
+        };
+
+        std::mt19937 gen (2020);
+        std::string const tokens[] = {"a", "bcd", ",", ",", "\"", "\"", "\"\"", "\n", "\r\n", " "};
+        for (auto i = 0; i != 300; ++i) {
+            std::string csv;
+            for (auto n = 1 + gen() % 60; n; --n)
+                csv += tokens[gen() % std::size(tokens)];
+            check.operator()<engine::state_machine, 1>(csv);
+            check.operator()<engine::state_machine, 64>(csv);
+            check.operator()<engine::structural_index, 1>(csv);
+            check.operator()<engine::structural_index, 64>(csv);
+            check.operator()<engine::direct, 64>(csv);
+        }
+
+        // quoted fields take no more allocations than plain parsing does
+        std::string csv;
+        for (auto i = 0; i != 1000; ++i)
+            csv += R"("a ""quoted"" value", "x,y" ,plain)" "\n";
+        auto allocations = [&](auto run) {
+            reader<trim_policy::alltrim> r (csv);
+            auto const before = heap_allocations;
+            run(r);
+            return heap_allocations - before;
+        };
+        std::size_t total = 0;
+        expect(allocations([&](auto & r) { r.run_spans([](auto &) {}); })
+            == allocations([&](auto & r) { r.run_unescaped([&](std::string_view v) { total += v.size(); }); }));
+        expect(total == 1000 * (std::string_view(R"(a "quoted" value)").size() + 3 + 5));
+    };
+
+    "a file unescaped in place stays intact"_test = [] {
+
+        std::string const csv = "name,quote\n\"Smith, J\",\"said \"\"hi\"\"\"\n";
+        {
+            std::ofstream ("unescape.csv", std::ios::binary) << csv;
+        }
+        std::vector<std::string> values;
+        reader r (std::filesystem::path("unescape.csv"));
+        r.run_unescaped([&](std::string_view v) { values.emplace_back(v); });
+        expect(values == std::vector<std::string>{"name", "quote", "Smith, J", R"(said "hi")"});
+
+        std::ifstream f ("unescape.csv", std::ios::binary);
+        expect(std::string(std::istreambuf_iterator<char>(f), {}) == csv);
+    };
+
+    // -- Topic change: Streamed archives --
+
+    // 100000 rows of 3 columns, 2.5 MB when inflated, with quoted line breaks and quotes
+    auto const parse_streamed = [](std::filesystem::path const & path) {
+        constexpr auto rows = 100000u, period = 500u;
+        constexpr auto sum = rows / period * (period * (period - 1) / 2);
+
+        reader r (path);
+        expect(r.cols() == 3 && r.rows() == rows + 1 && r.rows<parallel>(2) == rows + 1);
+        expect(r.validate().validated_rows() == rows + 1 && r.validate<parallel>(2).validated_cols() == 3);
+        // one window at a time is kept in memory
+        expect(r.size() < 2 * 1024 * 1024);
+
+        auto ids {0ull}, twice {0ull};
+        auto texts {0u};
+        r.run_rows([](auto) {}, [&](auto & rs) {
+            auto const id = rs[0].template as<unsigned>();
+            ids += id;
+            twice += rs[2].template as<unsigned>();
+            texts += rs[1] == "say \"" + std::to_string(id) + "\"\nnow";
+        });
+        expect(ids == sum && twice == 2 * sum && texts == rows);
+
+        // spans: the header is handed over once, every row ends
+        auto headers {0u}, values {0u}, new_rows {0u};
+        r.run_spans([&](auto &) { ++headers; }, [&](auto &) { ++values; }, [&] { ++new_rows; });
+        expect(headers == 3 && values == 3 * rows && new_rows == rows + 1);
+
+        expect(r.column_as<unsigned>("twice").size() == rows);
+
+        // the parsers of every policy and engine go from window to window
+        using mfs_reader = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::trace<100>>;
+        using er_reader = reader<trim_policy::no_trimming, double_quotes, comma_delimiter, non_mac_ln_brk, MFS::no_trace, ER::ignore, engine::state_machine>;
+        expect(mfs_reader(path).rows() == rows + 1 && mfs_reader(path).validate().validated_rows() == rows + 1);
+        expect(er_reader(path).validate().validated_rows() == rows + 1);
+
+        // skips go on past the first window, as far as with the CSV in memory
+        for (auto const skip : {60000u, rows}) {
+            reader k (path);
+            k.skip_rows(skip);
+            auto firsts {0u}, first {0u};
+            k.run_rows([&](auto & rs) { first = firsts++ ? first : rs[0].template as<unsigned>(); });
+            expect(k.rows() == rows + 1 - skip && firsts == rows + 1 - skip && first == (skip - 1) % period);
+            expect(k.cols() == 3 && k.validate().validated_rows() == rows + 1 - skip);
+        }
+
+        // skips add up across windows, skipping no rows goes back to the first one
+        reader chained (path);
+        chained.skip_rows(30000).skip_rows(40000).skip_rows(1);
+        auto firsts {0u}, first {0u};
+        chained.run_rows([&](auto & rs) { first = firsts++ ? first : rs[0].template as<unsigned>(); });
+        expect(chained.rows() == rows - 70000 && firsts == rows - 70000 && first == 70000 % period);
+        expect(chained.skip_rows(0).rows() == rows + 1);
+
+        // skipping and parallel iteration over the windows
+        reader s (path);
+        ids = 0;
+        s.skip_rows(1).run_rows_parallel(2, [&](auto & rs) { ids += rs[0].template as<unsigned>(); }, reader<>::delivery::ordered);
+        expect(ids == sum);
+
+        ids = 0;
+        reader (path).run_unescaped([&, column = 0u](std::string_view v) mutable {
+            if (column++ % 3 == 0 && column > 3)
+                ids += std::stoul(std::string(v));
+        });
+        expect(ids == sum);
+    };
+
+    "a .gz archive is parsed window by window"_test = [&] {
+        parse_streamed("stream.csv.gz");
+    };
+
+    "a .bz2 archive of two streams is parsed window by window"_test = [&] {
+        parse_streamed("stream.csv.bz2");
+    };
+
+    "a .zst archive of two frames is parsed window by window"_test = [&] {
+        parse_streamed("stream.csv.zst");
+
+        std::ifstream whole ("stream.csv.zst", std::ios::binary);
+        std::string cut (1000, '\0');
+        whole.read(cut.data(), static_cast<std::streamsize>(cut.size()));
+        std::ofstream ("truncated.csv.zst", std::ios::binary) << cut;
+        expect(throws([] { (void) reader (std::filesystem::path("truncated.csv.zst")).rows(); }));
+    };
+
+    "the frames of a .zst archive decoded by threads come in order"_test = [&] {
+        // 39 frames of 64 KB, cutting rows anywhere, and a seek table
+        parse_streamed("frames.csv.zst");
+
+        auto const inflate = [](csv_co::detail::byte_stream & s) {
+            std::string csv;
+            for (auto piece = s.next(); !piece.empty(); piece = s.next())
+                csv.append(piece.data(), piece.size());
+            return csv;
+        };
+        csv_co::detail::zst_stream serial ("stream.csv.zst");
+        auto const expected = inflate(serial);
+
+        // frames from the seek table, or from the headers of the frames and of their blocks
+        std::ifstream seekable ("frames.csv.zst", std::ios::binary), plain ("stream.csv.zst", std::ios::binary);
+        auto const frames = csv_co::detail::zst_frames(seekable);
+        auto const two_frames = csv_co::detail::zst_frames(plain);
+        expect(frames.size() == 39 && frames[1].offset == frames[0].size && frames[1].content == 65536);
+        expect(two_frames.size() == 2 && two_frames[0].content + two_frames[1].content == expected.size());
+
+        // only frames of known and bounded sizes are decompressed whole, others are streamed
+        using frames_stream = csv_co::detail::zst_frames_stream;
+        expect(frames_stream::bounded(frames) && frames_stream::bounded(two_frames));
+        auto unknown = two_frames, large = two_frames;
+        unknown[1].content = ZSTD_CONTENTSIZE_UNKNOWN;
+        large[1].content = frames_stream::max_frame + 1;
+        expect(!frames_stream::bounded(unknown) && !frames_stream::bounded(large));
+        auto smaller = two_frames;
+        --smaller[1].content;
+        expect(throws([&] { frames_stream s ("stream.csv.zst", large, 2); (void) inflate(s); }));
+        expect(throws([&] { frames_stream s ("stream.csv.zst", smaller, 2); (void) inflate(s); }));
+
+        for (auto threads : {1u, 3u}) {
+            csv_co::detail::zst_frames_stream s ("frames.csv.zst", frames, threads);
+            expect(inflate(s) == expected);
+            s.rewind();
+            expect(inflate(s) == expected);
+        }
+        csv_co::detail::zst_frames_stream s ("stream.csv.zst", two_frames, 2);
+        expect(inflate(s) == expected);
+    };
+
+    "a seekable .zst archive is read on from the frame holding an offset"_test = [] {
+
+        auto const inflate = [](csv_co::detail::byte_stream & s) {
+            std::string csv;
+            for (auto piece = s.next(); !piece.empty(); piece = s.next())
+                csv.append(piece.data(), piece.size());
+            return csv;
+        };
+        csv_co::detail::zst_stream serial ("stream.csv.zst");
+        auto const expected = inflate(serial);
+
+        std::ifstream seekable ("frames.csv.zst", std::ios::binary);
+        auto const frames = csv_co::detail::zst_frames(seekable);
+        auto const last = (frames.size() - 1) * 65536;
+        for (auto threads : {1u, 3u}) {
+            csv_co::detail::zst_frames_stream s ("frames.csv.zst", frames, threads);
+            for (auto const & [offset, start] : std::initializer_list<std::pair<std::uint64_t, std::uint64_t>> {
+                    {0, 0}, {65535, 0}, {65536, 65536}, {200000, 3 * 65536}, {expected.size() - 1, last}}) {
+                expect(s.seek(offset) == start) << offset;
+                expect(inflate(s) == expected.substr(start)) << offset;
+            }
+            // beyond the data, then back to the beginning, in the middle of reading
+            expect(s.seek(expected.size()) == expected.size() && inflate(s).empty());
+            expect(s.seek(500000) == 7 * 65536);
+            auto const piece = s.next();
+            expect(std::string_view(piece.data(), piece.size()) == std::string_view(expected).substr(7 * 65536, 65536));
+            s.rewind();
+            expect(inflate(s) == expected);
+        }
+
+        // frames of unknown sizes cannot be sought past
+        auto unknown = frames;
+        unknown[2].content = ZSTD_CONTENTSIZE_UNKNOWN;
+        csv_co::detail::zst_frames_stream s ("frames.csv.zst", unknown, 1);
+        expect(s.seek(100000) == 65536);
+        expect(throws([&] { (void) s.seek(200000); }));
+    };
+
+    "the blocks of a .bz2 archive decoded by threads come in order"_test = [] {
+
+        auto const inflate = [](bz2_connector::stream_reader & s) {
+            std::string csv;
+            for (auto piece = s.read(); !piece.empty(); piece = s.read())
+                csv.append(piece);
+            return csv;
+        };
+
+        bz2_connector::stream_reader serial ("stream.csv.bz2", 1);
+        auto const expected = inflate(serial);
+        expect(expected.size() == 2545014u && serial.streams() == 2);
+
+        for (auto threads : {2u, 3u, 8u}) {
+            bz2_connector::stream_reader s ("stream.csv.bz2", threads);
+            expect(inflate(s) == expected && s.streams() == 2);
+            s.rewind();
+            expect(inflate(s) == expected);
+        }
+        bz2_connector::stream_reader tiny ("dummy.csv.bz2", 4);
+        expect(inflate(tiny) == bz2_connector::read_all("dummy.csv.bz2"));
+        expect(throws([] { bz2_connector::stream_reader s ("game.csv", 2); s.read(); }));
+    };
+
+    "magic numbers within the compressed data of a .bz2 block don't cut it"_test = [] {
+
+        std::string csv;
+        for (auto i = 0u; i != 2000; ++i)
+            csv += std::to_string(i * 7919 % 10007) + ',' + std::to_string(i) + '\n';
+        std::string packed (csv.size() + csv.size() / 100 + 600, '\0');
+        auto packed_size = static_cast<unsigned>(packed.size());
+        expect(BZ2_bzBuffToBuffCompress(packed.data(), &packed_size, csv.data(), static_cast<unsigned>(csv.size()), 9, 0, 0) == BZ_OK);
+
+        std::vector<bool> bits;
+        for (auto i = 0u; i != packed_size; ++i)
+            for (auto b = 7; b >= 0; --b)
+                bits.push_back(packed[i] >> b & 1);
+        auto const read = [&](std::size_t at, unsigned n) {
+            std::uint64_t v = 0;
+            for (auto i = 0u; i != n; ++i)
+                v = v << 1 | bits[at + i];
+            return v;
+        };
+        auto const write = [&](std::size_t at, unsigned n, std::uint64_t v) {
+            for (auto i = 0u; i != n; ++i)
+                bits[at + i] = v >> (n - 1 - i) & 1;
+        };
+
+        // Stream header, block magic, CRC, randomized bit, origPtr, mapping table, then the selectors of the coding
+        // tables. Selectors after the ones used are read and ignored: both magic numbers are put there, their runs of
+        // ones being short enough for the selectors of six tables.
+        std::size_t at = 32 + 48 + 32 + 1 + 24;
+        at += 16 + 16 * std::popcount(read(at, 16));
+        expect(read(at, 3) == 6u) << "six coding tables";
+        auto const selectors_at = at + 3;
+        auto const selectors = read(selectors_at, 15);
+        at = selectors_at + 15;
+        for (auto i = 0u; i != selectors; ++i)
+            while (bits[at++]) {}
+        std::vector<bool> magics;
+        for (auto magic : {0x314159265359ull, 0x177245385090ull})
+            for (auto b = 47; b >= 0; --b)
+                magics.push_back(magic >> b & 1);
+        magics.push_back(false);
+        bits.insert(bits.begin() + static_cast<std::ptrdiff_t>(at), magics.begin(), magics.end());
+        write(selectors_at, 15, selectors + static_cast<std::uint64_t>(std::count(magics.begin(), magics.end(), false)));
+
+        std::string file ((bits.size() + 7) / 8, '\0');
+        for (auto i = 0u; i != bits.size(); ++i)
+            file[i / 8] = static_cast<char>(file[i / 8] | bits[i] << (7 - i % 8));
+        std::ofstream ("false_magic.csv.bz2", std::ios::binary) << file;
+
+        auto const inflate = [](char const * path, unsigned threads) {
+            bz2_connector::stream_reader s (path, threads);
+            std::string csv;
+            for (auto piece = s.read(); !piece.empty(); piece = s.read())
+                csv.append(piece);
+            return csv;
+        };
+        expect(inflate("false_magic.csv.bz2", 1) == csv);
+        expect(inflate("false_magic.csv.bz2", 3) == csv);
+
+        // damaged data isn't joined with what follows further than a block may go
+        file[file.size() / 2] ^= 0x10;
+        std::ofstream ("damaged.csv.bz2", std::ios::binary) << file;
+        expect(throws([&] { inflate("damaged.csv.bz2", 1); }) && throws([&] { inflate("damaged.csv.bz2", 3); }));
+    };
+}